@@ -1,9 +1,12 @@
 #include "Miscellaneous.hpp"
+#include <apps/openmw-mp/Script/Script.hpp>
 #include <apps/openmw-mp/Script/ScriptFunctions.hpp>
 #include <apps/openmw-mp/Networking.hpp>
 #include <components/openmw-mp/Log.hpp>
 
+#include <fstream>
 #include <iostream>
+#include <sstream>
 using namespace std;
 
 unsigned int MiscellaneousFunctions::GetLastPlayerId() noexcept
@@ -30,3 +33,31 @@ void MiscellaneousFunctions::LogAppend(unsigned short level, const char *message
 {
     LOG_APPEND(level, "[Script]: %s", message);
 }
+
+void MiscellaneousFunctions::SetScriptProfilerEnabled(bool enabled) noexcept
+{
+    Misc::ScriptProfiler &profiler = Script::GetProfiler();
+
+    if (enabled && !profiler.isEnabled())
+        profiler.clear();
+
+    profiler.setEnabled(enabled);
+}
+
+void MiscellaneousFunctions::LogScriptProfile(unsigned int maxEntries) noexcept
+{
+    stringstream summary;
+    Script::GetProfiler().writeSummary(summary, maxEntries);
+
+    string line;
+    while (getline(summary, line))
+        LOG_MESSAGE_SIMPLE(Log::LOG_INFO, "[Profiler]: %s", line.c_str());
+}
+
+bool MiscellaneousFunctions::WriteScriptProfile(const char *path) noexcept
+{
+    ofstream stream(path);
+    Script::GetProfiler().writeFolded(stream);
+
+    return static_cast<bool>(stream);
+}
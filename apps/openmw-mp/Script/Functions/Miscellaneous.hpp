@@ -10,7 +10,11 @@
     {"SetCurrentMpNum",  MiscellaneousFunctions::SetCurrentMpNum},\
     \
     {"LogMessage",       MiscellaneousFunctions::LogMessage},\
-    {"LogAppend",        MiscellaneousFunctions::LogAppend}
+    {"LogAppend",        MiscellaneousFunctions::LogAppend},\
+    \
+    {"SetScriptProfilerEnabled", MiscellaneousFunctions::SetScriptProfilerEnabled},\
+    {"LogScriptProfile",         MiscellaneousFunctions::LogScriptProfile},\
+    {"WriteScriptProfile",       MiscellaneousFunctions::WriteScriptProfile}
 
 class MiscellaneousFunctions
 {
@@ -22,6 +26,10 @@ public:
 
     static void LogMessage(unsigned short level, const char *message) noexcept;
     static void LogAppend(unsigned short level, const char *message) noexcept;
+
+    static void SetScriptProfilerEnabled(bool enabled) noexcept;
+    static void LogScriptProfile(unsigned int maxEntries) noexcept;
+    static bool WriteScriptProfile(const char *path) noexcept;
 };
 
 #endif //OPENMW_MISCELLANEOUSAPI_HPP
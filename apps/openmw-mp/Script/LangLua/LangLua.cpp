@@ -9,6 +9,17 @@
 
 using namespace std;
 
+namespace
+{
+    // Instructions are counted in steps of this size, so that the hook is called rarely
+    constexpr int instructionStep = 100;
+
+    void CountInstructions(lua_State *, lua_Debug *)
+    {
+        Script::GetProfiler().addInstructions(instructionStep);
+    }
+}
+
 lib_t LangLua::GetInterface()
 {
     return reinterpret_cast<lib_t>(lua);
@@ -193,6 +204,12 @@ boost::any LangLua::Call(const char *name, const char *argl, const std::vector<b
         }
     }
 
+    // Only count instructions while they are profiled
+    if (Script::GetProfiler().isEnabled())
+        lua_sethook(lua, CountInstructions, LUA_MASKCOUNT, instructionStep);
+    else if (lua_gethook(lua))
+        lua_sethook(lua, nullptr, 0, 0);
+
     luabridge::LuaException::pcall (lua, n_args, 1);
     return boost::any(luabridge::LuaRef::fromStack(lua, -1));
 }
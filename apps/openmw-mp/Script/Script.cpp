@@ -15,6 +15,7 @@
 using namespace std;
 
 Script::ScriptList Script::scripts;
+Misc::ScriptProfiler Script::profiler;
 
 Script::Script(const char *path)
 {
@@ -107,3 +108,8 @@ void Script::LoadScript(const char *script, const char *base)
     snprintf(path, sizeof(path), Utils::convertPath("%s/%s/%s").c_str(), base, "scripts", script);
     Script::scripts.emplace_back(new Script(path));
 }
+
+Misc::ScriptProfiler &Script::GetProfiler()
+{
+    return profiler;
+}
@@ -10,6 +10,8 @@
 #include "ScriptFunctions.hpp"
 #include "Language.hpp"
 
+#include <components/misc/scriptprofiler.hpp>
+
 #include <boost/any.hpp>
 #include <unordered_map>
 #include <memory>
@@ -47,6 +49,8 @@ private:
     typedef std::vector<std::unique_ptr<Script>> ScriptList;
     static ScriptList scripts;
 
+    static Misc::ScriptProfiler profiler;
+
     Script(const char *path);
 
     Script(const Script&) = delete;
@@ -59,6 +63,9 @@ public:
     static void LoadScripts(char* scripts, const char* base);
     static void UnloadScripts();
 
+    // Records the callbacks run by Call, per callback name
+    static Misc::ScriptProfiler &GetProfiler();
+
     static constexpr ScriptCallbackData const& CallBackData(const unsigned int I, const unsigned int N = 0) {
         return callbacks[N].index == I ? callbacks[N] : CallBackData(I, N + 1);
     }
@@ -94,6 +101,8 @@ public:
 
             LOG_MESSAGE_SIMPLE(Log::LOG_VERBOSE, "Called function \"%s\"", data.name);
 
+            Misc::ScriptProfiler::Scope scope(profiler, data.name);
+
             if (script->script_type == SCRIPT_CPP)
                 result = reinterpret_cast<FunctionEllipsis<CallBackReturn<I>>>(callback)(std::forward<Args>(args)...);
 #if defined (ENABLE_PAWN)
@@ -136,6 +145,8 @@ public:
 
             LOG_MESSAGE_SIMPLE(Log::LOG_VERBOSE, "Called function \"%s\"", data.name);
 
+            Misc::ScriptProfiler::Scope scope(profiler, data.name);
+
             if (script->script_type == SCRIPT_CPP)
                 reinterpret_cast<FunctionEllipsis<CallBackReturn<I>>>(callback)(std::forward<Args>(args)...);
 #if defined (ENABLE_PAWN)
@@ -1,7 +1,10 @@
 #include "engine.hpp"
 
+#include <algorithm>
 #include <iomanip>
+#include <sstream>
 
+#include <boost/filesystem.hpp>
 #include <boost/filesystem/fstream.hpp>
 
 #include <osgViewer/ViewerEventHandlers>
@@ -69,14 +72,84 @@ namespace
     }
 }
 
+std::string OMW::Engine::getContentSignature() const
+{
+    // Identify the content files by name, size and modification time, so editing a plugin
+    // invalidates everything derived from the previous version
+    std::ostringstream signature;
+    for (std::vector<std::string>::const_iterator it = mContentFiles.begin(); it != mContentFiles.end(); ++it)
+    {
+        signature << *it << ";";
+
+        boost::filesystem::path filename(*it);
+        const Files::MultiDirCollection& collection = mFileCollections.getCollection(filename.extension().string());
+        if (!collection.doesExist(*it))
+            continue;
+
+        boost::system::error_code ec;
+        const boost::filesystem::path path = collection.getPath(*it);
+        signature << boost::filesystem::file_size(path, ec) << ";" << boost::filesystem::last_write_time(path, ec) << ";";
+    }
+    return signature.str();
+}
+
 void OMW::Engine::executeLocalScripts()
 {
     MWWorld::LocalScripts& localScripts = mEnvironment.getWorld()->getLocalScripts();
+    MWBase::ScriptManager* scriptManager = mEnvironment.getScriptManager();
 
-    localScripts.startIteration();
     std::pair<std::string, MWWorld::Ptr> script;
+
+    // Self-contained scripts only change their own locals, so they can run concurrently before the others.
+    // If any other script accesses locals of other scripts, it could observe the changed order.
+    std::vector<MWWorld::LiveCellRefBase*> ranSelfContained;
+    if (scriptManager->hasThreads())
+    {
+        std::vector<std::pair<std::string, MWWorld::Ptr> > selfContained;
+        bool keepOrder = false;
+
+        localScripts.startIteration();
+        while (localScripts.getNext(script))
+        {
+            /*
+                Start of tes3mp addition
+
+                Scripts that send packets about their value changes have to stay on the main thread
+            */
+            if (mwmp::Main::isValidPacketScript(script.first))
+                continue;
+            /*
+                End of tes3mp addition
+            */
+
+            if (scriptManager->isSelfContained(script.first))
+                selfContained.push_back(script);
+            else if (scriptManager->usesMemberVariables(script.first))
+            {
+                keepOrder = true;
+                break;
+            }
+        }
+
+        if (!keepOrder && selfContained.size() > 1)
+        {
+            scriptManager->runSelfContained(selfContained);
+
+            ranSelfContained.reserve(selfContained.size());
+            for (std::vector<std::pair<std::string, MWWorld::Ptr> >::const_iterator iter = selfContained.begin();
+                iter != selfContained.end(); ++iter)
+                ranSelfContained.push_back(iter->second.getBase());
+            std::sort(ranSelfContained.begin(), ranSelfContained.end());
+        }
+    }
+
+    localScripts.startIteration();
     while (localScripts.getNext(script))
     {
+        if (!ranSelfContained.empty() &&
+            std::binary_search(ranSelfContained.begin(), ranSelfContained.end(), script.second.getBase()))
+            continue;
+
         MWScript::InterpreterContext interpreterContext (
             &script.second.getRefData().getLocals(), script.second);
 
@@ -96,7 +169,7 @@ void OMW::Engine::executeLocalScripts()
             End of tes3mp addition
         */
 
-        mEnvironment.getScriptManager()->run (script.first, interpreterContext);
+        scriptManager->run (script.first, interpreterContext);
     }
 }
 
@@ -213,6 +286,8 @@ void OMW::Engine::frame(float frametime)
 
             stats->setAttribute(frameNumber, "WorkQueue", mWorkQueue->getNumItems());
             stats->setAttribute(frameNumber, "WorkThread", mWorkQueue->getNumActiveThreads());
+
+            mEnvironment.getMechanicsManager()->reportStats(frameNumber, stats);
         }
 
     }
@@ -491,6 +566,8 @@ void OMW::Engine::prepareEngine (Settings::Manager & settings)
         Settings::Manager::getString("texture mipmap", "General"),
         Settings::Manager::getInt("anisotropy", "General")
     );
+    if (Settings::Manager::getBool("template disk cache", "Cells"))
+        mResourceSystem->getSceneManager()->setTemplateCachePath((mCfgMgr.getCachePath() / "templates").string());
 
     int numThreads = Settings::Manager::getInt("preload num threads", "Cells");
     if (numThreads <= 0)
@@ -567,8 +644,13 @@ void OMW::Engine::prepareEngine (Settings::Manager & settings)
     mScriptContext = new MWScript::CompilerContext (MWScript::CompilerContext::Type_Full);
     mScriptContext->setExtensions (&mExtensions);
 
-    mEnvironment.setScriptManager (new MWScript::ScriptManager (mEnvironment.getWorld()->getStore(), *mScriptContext, mWarningsMode,
-        mScriptBlacklistUse ? mScriptBlacklist : std::vector<std::string>()));
+    MWScript::ScriptManager* scriptManager = new MWScript::ScriptManager (mEnvironment.getWorld()->getStore(), *mScriptContext, mWarningsMode,
+        mScriptBlacklistUse ? mScriptBlacklist : std::vector<std::string>());
+    mEnvironment.setScriptManager (scriptManager);
+    if (Settings::Manager::getBool("script disk cache", "General"))
+        scriptManager->setDiskCache((mCfgMgr.getCachePath() / "scripts.bin").string(), getContentSignature());
+    scriptManager->setThreads(Settings::Manager::getInt("script threads", "Game"));
+    scriptManager->setProfilePath((mCfgMgr.getLogPath() / "scriptprofile.folded").string());
 
     // Create game mechanics system
     MWMechanics::MechanicsManager* mechanics = new MWMechanics::MechanicsManager;
@@ -744,9 +826,15 @@ void OMW::Engine::go()
         }
         else
         {
+            // Physics may catch up with this frame while it is being rendered.
+            // Nothing in the traversals below may access a Ptr, see MWBase::World::startPhysicsStep
+            mEnvironment.getWorld()->startPhysicsStep();
+
             mViewer->eventTraversal();
             mViewer->updateTraversal();
             mViewer->renderingTraversals();
+
+            mEnvironment.getWorld()->finishPhysicsStep();
         }
 
         if (framerateLimit > 0.f)
@@ -116,6 +116,9 @@ namespace OMW
             Engine (const Engine&);
             Engine& operator= (const Engine&);
 
+            /// Describes the loaded content files, to tell if data cached on disk was derived from them.
+            std::string getContentSignature() const;
+
             void executeLocalScripts();
 
             void frame (float dt);
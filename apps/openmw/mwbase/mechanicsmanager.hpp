@@ -10,6 +10,7 @@
 namespace osg
 {
     class Vec3f;
+    class Stats;
 }
 
 namespace ESM
@@ -32,6 +33,11 @@ namespace Loading
     class Listener;
 }
 
+namespace MWMechanics
+{
+    class PathgridNetwork;
+}
+
 namespace MWBase
 {
     /// \brief Interface for game mechanics manager (implemented in MWMechanics)
@@ -58,6 +64,9 @@ namespace MWBase
             virtual void updateCell(const MWWorld::Ptr &old, const MWWorld::Ptr &ptr) = 0;
             ///< Moves an object to a new cell
 
+            virtual void updatePosition(const MWWorld::Ptr& ptr) = 0;
+            ///< Has to be called after an object has been moved, so that proximity queries see its new position
+
             virtual void drop (const MWWorld::CellStore *cellStore) = 0;
             ///< Deregister all objects in the given cell.
 
@@ -73,6 +82,9 @@ namespace MWBase
 
             virtual void advanceTime (float duration) = 0;
 
+            virtual void reportStats (unsigned int frameNumber, osg::Stats* stats) const = 0;
+            ///< Report the work done by the last update to the viewer stats.
+
             virtual void setPlayerName (const std::string& name) = 0;
             ///< Set player name.
 
@@ -251,6 +263,9 @@ namespace MWBase
             virtual void applyWerewolfAcrobatics(const MWWorld::Ptr& actor) = 0;
 
             virtual void cleanupSummonedCreature(const MWWorld::Ptr& caster, int creatureActorId) = 0;
+
+            /// Links the pathgrids of exterior cells, for paths that leave the actor's cell.
+            virtual MWMechanics::PathgridNetwork& getPathgridNetwork() = 0;
     };
 }
 
@@ -2,6 +2,7 @@
 #define GAME_MWBASE_SCRIPTMANAGER_H
 
 #include <string>
+#include <vector>
 
 namespace Interpreter
 {
@@ -18,6 +19,16 @@ namespace MWScript
     class GlobalScripts;
 }
 
+namespace MWWorld
+{
+    class Ptr;
+}
+
+namespace Misc
+{
+    class ScriptProfiler;
+}
+
 namespace MWBase
 {
     /// \brief Interface for script manager (implemented in MWScript)
@@ -49,6 +60,34 @@ namespace MWBase
             virtual const Compiler::Locals& getLocals (const std::string& name) = 0;
             ///< Return locals for script \a name.
 
+            virtual int getLocalIndex (const std::string& name, const std::string& variable, char type) = 0;
+            ///< Return index of local variable \a variable of type \a type in script \a name,
+            /// or -1 if there is no such variable.
+
+            virtual MWWorld::Ptr getReference (const std::string& id, bool activeOnly) = 0;
+            ///< Like World::getPtr, but reuses the result of an earlier search as long as it can't be stale.
+
+            virtual bool isSelfContained (const std::string& name) = 0;
+            ///< Does the script only use its own local variables (compile first, if not compiled yet)?
+            /// Self-contained local scripts of different references can run at the same time.
+
+            virtual bool usesMemberVariables (const std::string& name) = 0;
+            ///< Does the script access local variables of other scripts (compile first, if not compiled yet)?
+
+            virtual bool hasThreads() const = 0;
+            ///< Are threads available for running self-contained scripts?
+
+            virtual void runSelfContained (const std::vector<std::pair<std::string, MWWorld::Ptr> >& scripts) = 0;
+            ///< Run the given self-contained local scripts (name, reference), spread over the available threads.
+            /// Other scripts in \a scripts are ignored.
+
+            virtual Misc::ScriptProfiler& getProfiler() = 0;
+            ///< Profiler for the scripts run by name.
+
+            virtual std::string writeProfile() = 0;
+            ///< Write the call stacks recorded by the profiler to a file, for flame graph tools.
+            /// \return Path of the file, or an empty string if it could not be written.
+
             virtual MWScript::GlobalScripts& getGlobalScripts() = 0;
    };
 }
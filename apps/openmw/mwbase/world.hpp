@@ -138,6 +138,10 @@ namespace MWBase
             virtual bool hasCellChanged() const = 0;
             ///< Has the set of active cells changed, since the last frame?
 
+            virtual unsigned int getCellChangeCount() const = 0;
+            ///< Incremented whenever a cell is loaded or unloaded, or an object is moved to a different cell.
+            /// A Ptr found by searchPtr before that may be stale afterwards.
+
             virtual bool isCellExterior() const = 0;
 
             virtual bool isCellQuasiExterior() const = 0;
@@ -363,6 +367,16 @@ namespace MWBase
 
             virtual void update (float duration, bool paused) = 0;
 
+            virtual void startPhysicsStep() = 0;
+            ///< Solve the movement prepared during this frame in the background, if the "async physics" setting is enabled.
+            /// The world must not be used until finishPhysicsStep() returns.
+            /// @note The step never touches a Ptr or other game state, everything it needs is copied when the movement
+            /// is prepared. Code running during the render traversals (update callbacks, cull callbacks) must in turn
+            /// not access Ptrs or call into the physics system.
+
+            virtual void finishPhysicsStep() = 0;
+            ///< Wait for the step started by startPhysicsStep() to complete.
+
             virtual MWWorld::Ptr placeObject (const MWWorld::ConstPtr& object, float cursorX, float cursorY, int amount) = 0;
             ///< copy and place an object into the gameworld at the specified cursor position
             /// @param object
@@ -13,6 +13,7 @@
 
 #include <components/compiler/exception.hpp>
 #include <components/compiler/errorhandler.hpp>
+#include <components/compiler/generator.hpp>
 #include <components/compiler/scanner.hpp>
 #include <components/compiler/locals.hpp>
 #include <components/compiler/output.hpp>
@@ -57,12 +58,14 @@
 #include "../mwmechanics/actorutil.hpp"
 
 #include "filter.hpp"
-#include "hypertextparser.hpp"
+#include "infoindex.hpp"
 
 namespace MWDialogue
 {
     DialogueManager::DialogueManager (const Compiler::Extensions& extensions, Translation::Storage& translationDataStorage) :
-      mTranslationDataStorage(translationDataStorage)
+      mChangedDependencies (0)
+      , mTopicsOutdated (true)
+      , mTranslationDataStorage(translationDataStorage)
       , mCompilerContext (MWScript::CompilerContext::Type_Dialogue)
       , mErrorStream(std::cout.rdbuf())
       , mErrorHandler(mErrorStream)
@@ -87,6 +90,8 @@ namespace MWDialogue
     void DialogueManager::clear()
     {
         mKnownTopics.clear();
+        mTopicKeywords.clear();
+        mInfoIndices.clear();
         mTalkedTo = false;
         mTemporaryDispositionChange = 0;
         mPermanentDispositionChange = 0;
@@ -99,7 +104,7 @@ namespace MWDialogue
 
     void DialogueManager::parseText (const std::string& text)
     {
-        std::vector<HyperTextParser::Token> hypertext = HyperTextParser::parseHyperText(text);
+        std::vector<HyperTextParser::Token> hypertext = HyperTextParser::parseHyperText(text, mTopicKeywords);
 
         for (std::vector<HyperTextParser::Token>::iterator tok = hypertext.begin(); tok != hypertext.end(); ++tok)
         {
@@ -133,7 +138,7 @@ namespace MWDialogue
                 mKnownTopics.insert( topicId );
         }
 
-        updateTopics();
+        updateKeywords();
     }
 
     void DialogueManager::startDialogue (const MWWorld::Ptr& actor)
@@ -169,7 +174,7 @@ namespace MWDialogue
         const MWWorld::Store<ESM::Dialogue> &dialogs =
             MWBase::Environment::get().getWorld()->getStore().get<ESM::Dialogue>();
 
-        Filter filter (actor, mChoice, mTalkedTo);
+        Filter filter (actor, mChoice, mTalkedTo, mInfoIndices);
 
         for (MWWorld::Store<ESM::Dialogue>::iterator it = dialogs.begin(); it != dialogs.end(); ++it)
         {
@@ -189,7 +194,7 @@ namespace MWDialogue
                     }
 
                     // first topics update so that parseText knows the keywords to highlight
-                    updateTopics();
+                    updateActorKnownTopics();
 
                     parseText (info->mResponse);
 
@@ -199,7 +204,8 @@ namespace MWDialogue
                     mLastTopic = Misc::StringUtils::lowerCase(it->mId);
 
                     // update topics again to accommodate changes resulting from executeScript
-                    updateTopics();
+                    updateChangedTopics();
+                    updateKeywords();
 
                     return;
                 }
@@ -270,11 +276,35 @@ namespace MWDialogue
         return success;
     }
 
+    void DialogueManager::noteStateChanges (int changes)
+    {
+        if (changes & Compiler::Generator::StateChange_Other)
+            mTopicsOutdated = true;
+
+        if (changes & Compiler::Generator::StateChange_Locals)
+            mChangedDependencies |= InfoIndex::Dependency_Locals;
+
+        if (changes & Compiler::Generator::StateChange_Globals)
+            mChangedDependencies |= InfoIndex::Dependency_Globals;
+
+        if (changes & Compiler::Generator::StateChange_Journal)
+            mChangedDependencies |= InfoIndex::Dependency_Journal;
+
+        // some dialogue globals are derived from the player's gold
+        if (changes & Compiler::Generator::StateChange_Items)
+            mChangedDependencies |= InfoIndex::Dependency_Items | InfoIndex::Dependency_Globals;
+
+        // Newly added topics are picked up by updateKeywords, and the availability of a topic doesn't depend on
+        // disposition, so the remaining changes don't require topics to be checked again.
+    }
+
     void DialogueManager::executeScript (const std::string& script, const MWWorld::Ptr& actor)
     {
         std::vector<Interpreter::Type_Code> code;
         if(compile(script, code, actor))
         {
+            noteStateChanges (Compiler::Generator::getStateChanges (code));
+
             try
             {
                 MWScript::InterpreterContext interpreterContext(&actor.getRefData().getLocals(), actor);
@@ -291,7 +321,7 @@ namespace MWDialogue
 
     void DialogueManager::executeTopic (const std::string& topic)
     {
-        Filter filter (mActor, mChoice, mTalkedTo);
+        Filter filter (mActor, mChoice, mTalkedTo, mInfoIndices);
 
         const MWWorld::Store<ESM::Dialogue> &dialogues =
             MWBase::Environment::get().getWorld()->getStore().get<ESM::Dialogue>();
@@ -358,37 +388,72 @@ namespace MWDialogue
     }
 
     void DialogueManager::updateTopics()
+    {
+        updateActorKnownTopics();
+        updateKeywords();
+    }
+
+    void DialogueManager::updateActorKnownTopics()
     {
         updateGlobals();
 
-        std::list<std::string> keywordList;
-        int choice = mChoice;
-        mChoice = -1;
         mActorKnownTopics.clear();
+        mChangedDependencies = 0;
+        mTopicsOutdated = false;
 
         const MWWorld::Store<ESM::Dialogue> &dialogs =
             MWBase::Environment::get().getWorld()->getStore().get<ESM::Dialogue>();
 
-        Filter filter (mActor, mChoice, mTalkedTo);
+        // choices are not taken into account for the list of topics
+        Filter filter (mActor, -1, mTalkedTo, mInfoIndices);
 
         for (MWWorld::Store<ESM::Dialogue>::iterator iter = dialogs.begin(); iter != dialogs.end(); ++iter)
         {
             if (iter->mType == ESM::Dialogue::Topic)
             {
                 if (filter.responseAvailable (*iter))
-                {
-                    std::string lower = Misc::StringUtils::lowerCase(iter->mId);
-                    mActorKnownTopics.insert (lower);
+                    mActorKnownTopics.insert (Misc::StringUtils::lowerCase(iter->mId));
+            }
+        }
+    }
 
-                    //does the player know the topic?
-                    if (mKnownTopics.count(lower))
-                    {
-                        keywordList.push_back (iter->mId);
-                    }
-                }
+    void DialogueManager::updateChangedTopics()
+    {
+        if (mTopicsOutdated)
+        {
+            updateActorKnownTopics();
+            return;
+        }
+
+        if (!mChangedDependencies)
+            return;
+
+        updateGlobals();
+
+        int changed = mChangedDependencies;
+        mChangedDependencies = 0;
+
+        const MWWorld::Store<ESM::Dialogue> &dialogs =
+            MWBase::Environment::get().getWorld()->getStore().get<ESM::Dialogue>();
+
+        Filter filter (mActor, -1, mTalkedTo, mInfoIndices);
+
+        for (MWWorld::Store<ESM::Dialogue>::iterator iter = dialogs.begin(); iter != dialogs.end(); ++iter)
+        {
+            if (iter->mType == ESM::Dialogue::Topic && (mInfoIndices.get (*iter).getDependencies() & changed))
+            {
+                std::string lower = Misc::StringUtils::lowerCase(iter->mId);
+
+                if (filter.responseAvailable (*iter))
+                    mActorKnownTopics.insert (lower);
+                else
+                    mActorKnownTopics.erase (lower);
             }
         }
+    }
 
+    void DialogueManager::updateKeywords()
+    {
         // check the available services of this actor
         int services = 0;
         if (mActor.getTypeName() == typeid(ESM::NPC).name())
@@ -442,15 +507,28 @@ namespace MWDialogue
 
         win->setServices (windowServices);
 
-        // sort again, because the previous sort was case-sensitive
+        std::list<std::string> keywordList;
+
+        const MWWorld::Store<ESM::Dialogue> &dialogs =
+            MWBase::Environment::get().getWorld()->getStore().get<ESM::Dialogue>();
+
+        for (std::set<std::string>::const_iterator iter = mActorKnownTopics.begin();
+            iter != mActorKnownTopics.end(); ++iter)
+        {
+            //does the player know the topic?
+            if (mKnownTopics.count(*iter))
+                keywordList.push_back (dialogs.find (*iter)->mId);
+        }
+
         keywordList.sort(Misc::StringUtils::ciLess);
         win->setKeywords(keywordList);
-
-        mChoice = choice;
     }
 
     void DialogueManager::keywordSelected (const std::string& keyword)
     {
+        // the world may have changed since the topics were last updated
+        updateActorKnownTopics();
+
         if(!mIsInChoice)
         {
             if(mDialogueMap.find(keyword) != mDialogueMap.end())
@@ -462,7 +540,8 @@ namespace MWDialogue
             }
         }
 
-        updateTopics();
+        updateChangedTopics();
+        updateKeywords();
     }
 
     bool DialogueManager::isInChoice() const
@@ -491,11 +570,14 @@ namespace MWDialogue
 
     void DialogueManager::questionAnswered (int answer)
     {
+        // the world may have changed since the topics were last updated
+        updateActorKnownTopics();
+
         mChoice = answer;
 
         if (mDialogueMap.find(mLastTopic) != mDialogueMap.end())
         {
-            Filter filter (mActor, mChoice, mTalkedTo);
+            Filter filter (mActor, mChoice, mTalkedTo, mInfoIndices);
 
             if (mDialogueMap[mLastTopic].mType == ESM::Dialogue::Topic
                     || mDialogueMap[mLastTopic].mType == ESM::Dialogue::Greeting)
@@ -535,7 +617,8 @@ namespace MWDialogue
             }
         }
 
-        updateTopics();
+        updateChangedTopics();
+        updateKeywords();
     }
 
     void DialogueManager::askQuestion (const std::string& question, int choice)
@@ -604,6 +687,8 @@ namespace MWDialogue
             text = "Bribe";
         }
 
+        updateActorKnownTopics();
+
         executeTopic (text + (success ? " Success" : " Fail"));
     }
 
@@ -619,7 +704,7 @@ namespace MWDialogue
 
     bool DialogueManager::checkServiceRefused()
     {
-        Filter filter (mActor, mChoice, mTalkedTo);
+        Filter filter (mActor, mChoice, mTalkedTo, mInfoIndices);
 
         const MWWorld::Store<ESM::Dialogue> &dialogues =
             MWBase::Environment::get().getWorld()->getStore().get<ESM::Dialogue>();
@@ -632,6 +717,7 @@ namespace MWDialogue
         {
             const ESM::DialInfo* info = infos[0];
 
+            updateActorKnownTopics();
             parseText (info->mResponse);
 
             const MWWorld::Store<ESM::GameSetting>& gmsts =
@@ -667,7 +753,7 @@ namespace MWDialogue
         const ESM::Dialogue *dial = store.get<ESM::Dialogue>().find(topic);
 
         const MWMechanics::CreatureStats& creatureStats = actor.getClass().getCreatureStats(actor);
-        Filter filter(actor, 0, creatureStats.hasTalkedToPlayer());
+        Filter filter(actor, 0, creatureStats.hasTalkedToPlayer(), mInfoIndices);
         const ESM::DialInfo *info = filter.search(*dial, false);
         if(info != NULL)
         {
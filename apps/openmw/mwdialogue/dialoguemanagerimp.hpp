@@ -13,6 +13,9 @@
 
 #include "../mwscript/compilercontext.hpp"
 
+#include "hypertextparser.hpp"
+#include "infoindex.hpp"
+
 namespace ESM
 {
     struct Dialogue;
@@ -31,6 +34,13 @@ namespace MWDialogue
 
             std::set<std::string> mActorKnownTopics;
 
+            HyperTextParser::TopicKeywords mTopicKeywords; // all dialogue IDs, for implicit keywords in texts
+            InfoIndexCache mInfoIndices;
+
+            // State changed by result scripts since mActorKnownTopics was last updated
+            int mChangedDependencies; // InfoIndex::Dependency flags
+            bool mTopicsOutdated; // anything else might have changed
+
             Translation::Storage& mTranslationDataStorage;
             MWScript::CompilerContext mCompilerContext;
             std::ostream mErrorStream;
@@ -49,11 +59,25 @@ namespace MWDialogue
             void parseText (const std::string& text);
 
             void updateTopics();
+
+            void updateActorKnownTopics();
+            ///< Find the topics the actor can talk about.
+
+            void updateChangedTopics();
+            ///< Update the topics the actor can talk about after result scripts ran. Only the topics that
+            /// depend on the state the scripts changed are checked again.
+
+            void updateKeywords();
+            ///< Update the services and topics shown in the dialogue window.
+
             void updateGlobals();
 
             bool compile (const std::string& cmd, std::vector<Interpreter::Type_Code>& code, const MWWorld::Ptr& actor);
             void executeScript (const std::string& script, const MWWorld::Ptr& actor);
 
+            void noteStateChanges (int changes);
+            ///< Record the Compiler::Generator::StateChange flags of a result script for updateChangedTopics.
+
             void executeTopic (const std::string& topic);
 
         public:
@@ -20,6 +20,7 @@
 #include "../mwmechanics/actorutil.hpp"
 
 #include "selectwrapper.hpp"
+#include "infoindex.hpp"
 
 bool MWDialogue::Filter::testActor (const ESM::DialInfo& info) const
 {
@@ -148,9 +149,9 @@ bool MWDialogue::Filter::testPlayer (const ESM::DialInfo& info) const
     return true;
 }
 
-bool MWDialogue::Filter::testSelectStructs (const ESM::DialInfo& info) const
+bool MWDialogue::Filter::testSelectStructs (const InfoIndex::Entry& info) const
 {
-    for (std::vector<ESM::DialInfo::SelectStruct>::const_iterator iter (info.mSelects.begin());
+    for (std::vector<SelectWrapper>::const_iterator iter (info.mSelects.begin());
         iter != info.mSelects.end(); ++iter)
         if (!testSelectStruct (*iter))
             return false;
@@ -178,7 +179,7 @@ bool MWDialogue::Filter::testFunctionLocal(const MWDialogue::SelectWrapper& sele
     if (scriptName.empty())
         return false; // no script
 
-    std::string name = Misc::StringUtils::lowerCase (select.getName());
+    const std::string& name = select.getName();
 
     const Compiler::Locals& localDefs =
         MWBase::Environment::get().getScriptManager()->getLocals (scriptName);
@@ -475,19 +476,19 @@ bool MWDialogue::Filter::getSelectStructBoolean (const SelectWrapper& select) co
 
         case SelectWrapper::Function_NotId:
 
-            return !Misc::StringUtils::ciEqual(mActor.getCellRef().getRefId(), select.getName());
+            return mActorId != select.getName();
 
         case SelectWrapper::Function_NotFaction:
 
-            return !Misc::StringUtils::ciEqual(mActor.getClass().getPrimaryFaction(mActor), select.getName());
+            return mActorFaction != select.getName();
 
         case SelectWrapper::Function_NotClass:
 
-            return !Misc::StringUtils::ciEqual(mActor.get<ESM::NPC>()->mBase->mClass, select.getName());
+            return mActorClass != select.getName();
 
         case SelectWrapper::Function_NotRace:
 
-            return !Misc::StringUtils::ciEqual(mActor.get<ESM::NPC>()->mBase->mRace, select.getName());
+            return mActorRace != select.getName();
 
         case SelectWrapper::Function_NotCell:
 
@@ -610,9 +611,28 @@ bool MWDialogue::Filter::hasFactionRankReputationRequirements (const MWWorld::Pt
     return stats.getFactionReputation (factionId)>=faction.mData.mRankData[rank].mFactReaction;
 }
 
-MWDialogue::Filter::Filter (const MWWorld::Ptr& actor, int choice, bool talkedToPlayer)
-: mActor (actor), mChoice (choice), mTalkedToPlayer (talkedToPlayer)
-{}
+MWDialogue::Filter::Filter (const MWWorld::Ptr& actor, int choice, bool talkedToPlayer, InfoIndexCache& infoIndices)
+: mActor (actor), mChoice (choice), mTalkedToPlayer (talkedToPlayer), mInfoIndices (infoIndices)
+{
+    mIsCreature = (mActor.getTypeName() != typeid (ESM::NPC).name());
+    mActorId = Misc::StringUtils::lowerCase (mActor.getCellRef().getRefId());
+
+    if (!mIsCreature)
+    {
+        const ESM::NPC *npc = mActor.get<ESM::NPC>()->mBase;
+        mActorRace = Misc::StringUtils::lowerCase (npc->mRace);
+        mActorClass = Misc::StringUtils::lowerCase (npc->mClass);
+        mActorFaction = Misc::StringUtils::lowerCase (mActor.getClass().getPrimaryFaction (mActor));
+    }
+}
+
+std::vector<const MWDialogue::InfoIndex::Entry *> MWDialogue::Filter::getCandidates (const ESM::Dialogue& dialogue) const
+{
+    std::vector<const InfoIndex::Entry *> candidates;
+    mInfoIndices.get (dialogue).getCandidates (mActorId, mActorRace, mActorClass, mActorFaction, mIsCreature,
+        candidates);
+    return candidates;
+}
 
 const ESM::DialInfo* MWDialogue::Filter::search (const ESM::Dialogue& dialogue, const bool fallbackToInfoRefusal) const
 {
@@ -626,11 +646,13 @@ const ESM::DialInfo* MWDialogue::Filter::search (const ESM::Dialogue& dialogue,
 
 std::vector<const ESM::DialInfo *> MWDialogue::Filter::listAll (const ESM::Dialogue& dialogue) const
 {
+    std::vector<const InfoIndex::Entry *> candidates = getCandidates (dialogue);
+
     std::vector<const ESM::DialInfo *> infos;
-    for (ESM::Dialogue::InfoContainer::const_iterator iter = dialogue.mInfo.begin(); iter!=dialogue.mInfo.end(); ++iter)
+    for (std::vector<const InfoIndex::Entry *>::const_iterator iter = candidates.begin(); iter!=candidates.end(); ++iter)
     {
-        if (testActor (*iter))
-            infos.push_back(&*iter);
+        if (testActor (*(*iter)->mInfo))
+            infos.push_back((*iter)->mInfo);
     }
     return infos;
 }
@@ -642,14 +664,18 @@ std::vector<const ESM::DialInfo *> MWDialogue::Filter::list (const ESM::Dialogue
 
     bool infoRefusal = false;
 
+    std::vector<const InfoIndex::Entry *> candidates = getCandidates (dialogue);
+
     // Iterate over topic responses to find a matching one
-    for (ESM::Dialogue::InfoContainer::const_iterator iter = dialogue.mInfo.begin();
-        iter!=dialogue.mInfo.end(); ++iter)
+    for (std::vector<const InfoIndex::Entry *>::const_iterator iter = candidates.begin();
+        iter!=candidates.end(); ++iter)
     {
-        if (testActor (*iter) && testPlayer (*iter) && testSelectStructs (*iter))
+        const ESM::DialInfo& info = *(*iter)->mInfo;
+
+        if (testActor (info) && testPlayer (info) && testSelectStructs (**iter))
         {
-            if (testDisposition (*iter, invertDisposition)) {
-                infos.push_back(&*iter);
+            if (testDisposition (info, invertDisposition)) {
+                infos.push_back(&info);
                 if (!searchAll)
                     break;
             }
@@ -668,13 +694,19 @@ std::vector<const ESM::DialInfo *> MWDialogue::Filter::list (const ESM::Dialogue
 
         const ESM::Dialogue& infoRefusalDialogue = *dialogues.find ("Info Refusal");
 
-        for (ESM::Dialogue::InfoContainer::const_iterator iter = infoRefusalDialogue.mInfo.begin();
-            iter!=infoRefusalDialogue.mInfo.end(); ++iter)
-            if (testActor (*iter) && testPlayer (*iter) && testSelectStructs (*iter) && testDisposition(*iter, invertDisposition)) {
-                infos.push_back(&*iter);
+        std::vector<const InfoIndex::Entry *> refusals = getCandidates (infoRefusalDialogue);
+
+        for (std::vector<const InfoIndex::Entry *>::const_iterator iter = refusals.begin();
+            iter!=refusals.end(); ++iter)
+        {
+            const ESM::DialInfo& info = *(*iter)->mInfo;
+
+            if (testActor (info) && testPlayer (info) && testSelectStructs (**iter) && testDisposition(info, invertDisposition)) {
+                infos.push_back(&info);
                 if (!searchAll)
                     break;
             }
+        }
     }
 
     return infos;
@@ -682,10 +714,14 @@ std::vector<const ESM::DialInfo *> MWDialogue::Filter::list (const ESM::Dialogue
 
 bool MWDialogue::Filter::responseAvailable (const ESM::Dialogue& dialogue) const
 {
-    for (ESM::Dialogue::InfoContainer::const_iterator iter = dialogue.mInfo.begin();
-        iter!=dialogue.mInfo.end(); ++iter)
+    std::vector<const InfoIndex::Entry *> candidates = getCandidates (dialogue);
+
+    for (std::vector<const InfoIndex::Entry *>::const_iterator iter = candidates.begin();
+        iter!=candidates.end(); ++iter)
     {
-        if (testActor (*iter) && testPlayer (*iter) && testSelectStructs (*iter))
+        const ESM::DialInfo& info = *(*iter)->mInfo;
+
+        if (testActor (info) && testPlayer (info) && testSelectStructs (**iter))
             return true;
     }
 
@@ -1,25 +1,36 @@
 #ifndef GAME_MWDIALOGUE_FILTER_H
 #define GAME_MWDIALOGUE_FILTER_H
 
+#include <string>
 #include <vector>
 
 #include "../mwworld/ptr.hpp"
 
+#include "infoindex.hpp"
+
 namespace ESM
 {
-    struct DialInfo;
     struct Dialogue;
 }
 
 namespace MWDialogue
 {
-    class SelectWrapper;
-
     class Filter
     {
             MWWorld::Ptr mActor;
             int mChoice;
             bool mTalkedToPlayer;
+            InfoIndexCache& mInfoIndices;
+
+            // lower case properties of mActor used for InfoIndex lookups
+            bool mIsCreature;
+            std::string mActorId;
+            std::string mActorRace;
+            std::string mActorClass;
+            std::string mActorFaction;
+
+            std::vector<const InfoIndex::Entry *> getCandidates (const ESM::Dialogue& dialogue) const;
+            ///< Infos of \a dialogue that are not ruled out for this actor by InfoIndex, in dialogue order.
 
             bool testActor (const ESM::DialInfo& info) const;
             ///< Is this the right actor for this \a info?
@@ -27,7 +38,7 @@ namespace MWDialogue
             bool testPlayer (const ESM::DialInfo& info) const;
             ///< Do the player and the cell the player is currently in match \a info?
 
-            bool testSelectStructs (const ESM::DialInfo& info) const;
+            bool testSelectStructs (const InfoIndex::Entry& info) const;
             ///< Are all select structs matching?
 
             bool testDisposition (const ESM::DialInfo& info, bool invert=false) const;
@@ -53,7 +64,7 @@ namespace MWDialogue
 
         public:
 
-            Filter (const MWWorld::Ptr& actor, int choice, bool talkedToPlayer);
+            Filter (const MWWorld::Ptr& actor, int choice, bool talkedToPlayer, InfoIndexCache& infoIndices);
 
             std::vector<const ESM::DialInfo *> list (const ESM::Dialogue& dialogue,
                 bool fallbackToInfoRefusal, bool searchAll, bool invertDisposition=false) const;
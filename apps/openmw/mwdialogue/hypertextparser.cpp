@@ -6,15 +6,19 @@
 #include "../mwworld/store.hpp"
 #include "../mwworld/esmstore.hpp"
 
-#include "keywordsearch.hpp"
-
 #include "hypertextparser.hpp"
 
 namespace MWDialogue
 {
     namespace HyperTextParser
     {
-        std::vector<Token> parseHyperText(const std::string & text)
+        void TopicKeywords::clear()
+        {
+            mSearch.clear();
+            mSeeded.clear();
+        }
+
+        std::vector<Token> parseHyperText(const std::string & text, TopicKeywords & keywords)
         {
             std::vector<Token> result;
             size_t pos_end, iteration_pos = 0;
@@ -27,7 +31,7 @@ namespace MWDialogue
                 if (pos_begin != std::string::npos && pos_end != std::string::npos)
                 {
                     if (pos_begin != iteration_pos)
-                        tokenizeKeywords(text.substr(iteration_pos, pos_begin - iteration_pos), result);
+                        tokenizeKeywords(text.substr(iteration_pos, pos_begin - iteration_pos), result, keywords);
 
                     std::string link = text.substr(pos_begin + 1, pos_end - pos_begin - 1);
                     result.push_back(Token(link, Token::ExplicitLink));
@@ -37,7 +41,7 @@ namespace MWDialogue
                 else
                 {
                     if (iteration_pos != text.size())
-                        tokenizeKeywords(text.substr(iteration_pos), result);
+                        tokenizeKeywords(text.substr(iteration_pos), result, keywords);
                     break;
                 }
             }
@@ -45,25 +49,25 @@ namespace MWDialogue
             return result;
         }
 
-        void tokenizeKeywords(const std::string & text, std::vector<Token> & tokens)
+        void tokenizeKeywords(const std::string & text, std::vector<Token> & tokens, TopicKeywords & keywords)
         {
             const MWWorld::Store<ESM::Dialogue> & dialogs =
                 MWBase::Environment::get().getWorld()->getStore().get<ESM::Dialogue>();
 
-            std::list<std::string> keywordList;
-            for (MWWorld::Store<ESM::Dialogue>::iterator it = dialogs.begin(); it != dialogs.end(); ++it)
-                keywordList.push_back(Misc::StringUtils::lowerCase(it->mId));
-            keywordList.sort(Misc::StringUtils::ciLess);
-
-            KeywordSearch<std::string, int /*unused*/> keywordSearch;
-
-            for (std::list<std::string>::const_iterator it = keywordList.begin(); it != keywordList.end(); ++it)
-                keywordSearch.seed(*it, 0 /*unused*/);
+            if (keywords.mSeeded.size() != dialogs.getSize())
+            {
+                for (MWWorld::Store<ESM::Dialogue>::iterator it = dialogs.begin(); it != dialogs.end(); ++it)
+                {
+                    std::string keyword = Misc::StringUtils::lowerCase(it->mId);
+                    if (keywords.mSeeded.insert(keyword).second)
+                        keywords.mSearch.seed(keyword, 0 /*unused*/);
+                }
+            }
 
-            std::vector<KeywordSearch<std::string, int /*unused*/>::Match> matches;
-            keywordSearch.highlightKeywords(text.begin(), text.end(), matches);
+            std::vector<TopicKeywords::TopicSearch::Match> matches;
+            keywords.mSearch.highlightKeywords(text.begin(), text.end(), matches);
 
-            for (std::vector<KeywordSearch<std::string, int /*unused*/>::Match>::const_iterator it = matches.begin(); it != matches.end(); ++it)
+            for (std::vector<TopicKeywords::TopicSearch::Match>::const_iterator it = matches.begin(); it != matches.end(); ++it)
             {
                 tokens.push_back(Token(std::string(it->mBeg, it->mEnd), Token::ImplicitKeyword));
             }
@@ -1,9 +1,12 @@
 #ifndef GAME_MWDIALOGUE_HYPERTEXTPARSER_H
 #define GAME_MWDIALOGUE_HYPERTEXTPARSER_H
 
+#include <set>
 #include <string>
 #include <vector>
 
+#include "keywordsearch.hpp"
+
 namespace MWDialogue
 {
     namespace HyperTextParser
@@ -25,10 +28,21 @@ namespace MWDialogue
             Type mType;
         };
 
+        /// Trie of all dialogue IDs, built once and only extended when dialogues are added to the store.
+        struct TopicKeywords
+        {
+            typedef KeywordSearch<std::string, int /*unused*/> TopicSearch;
+
+            TopicSearch mSearch;
+            std::set<std::string> mSeeded; ///< lowercase IDs already in mSearch
+
+            void clear();
+        };
+
         // In translations (at least Russian) the links are marked with @#, so
         // it should be a function to parse it
-        std::vector<Token> parseHyperText(const std::string & text);
-        void tokenizeKeywords(const std::string & text, std::vector<Token> & tokens);
+        std::vector<Token> parseHyperText(const std::string & text, TopicKeywords & keywords);
+        void tokenizeKeywords(const std::string & text, std::vector<Token> & tokens, TopicKeywords & keywords);
         size_t removePseudoAsterisks(std::string & phrase);
     }
 }
@@ -0,0 +1,110 @@
+#include "infoindex.hpp"
+
+#include <algorithm>
+
+#include <components/esm/loaddial.hpp>
+#include <components/misc/stringops.hpp>
+
+namespace MWDialogue
+{
+    InfoIndex::InfoIndex (const ESM::Dialogue& dialogue)
+    : mDependencies (0)
+    {
+        mEntries.reserve (dialogue.mInfo.size());
+
+        for (ESM::Dialogue::InfoContainer::const_iterator iter = dialogue.mInfo.begin();
+            iter!=dialogue.mInfo.end(); ++iter)
+        {
+            int index = static_cast<int> (mEntries.size());
+
+            mEntries.push_back (Entry());
+            Entry& entry = mEntries.back();
+            entry.mInfo = &*iter;
+            entry.mSelects.assign (iter->mSelects.begin(), iter->mSelects.end());
+
+            for (std::vector<SelectWrapper>::const_iterator select (entry.mSelects.begin());
+                select!=entry.mSelects.end(); ++select)
+                mDependencies |= getDependency (select->getFunction());
+
+            // Must match the checks in Filter::testActor
+            if (!iter->mActor.empty())
+                mByActor[Misc::StringUtils::lowerCase (iter->mActor)].push_back (index);
+            else if (!iter->mRace.empty())
+                mByRace[Misc::StringUtils::lowerCase (iter->mRace)].push_back (index);
+            else if (!iter->mClass.empty())
+                mByClass[Misc::StringUtils::lowerCase (iter->mClass)].push_back (index);
+            else if (!iter->mFactionLess && !iter->mFaction.empty())
+                mByFaction[Misc::StringUtils::lowerCase (iter->mFaction)].push_back (index);
+            else
+                mOther.push_back (index);
+        }
+    }
+
+    int InfoIndex::getDependency (SelectWrapper::Function function)
+    {
+        // Must match the state read by Filter for these functions
+        switch (function)
+        {
+            case SelectWrapper::Function_Journal: return Dependency_Journal;
+            case SelectWrapper::Function_Global: return Dependency_Globals;
+            case SelectWrapper::Function_Item: return Dependency_Items;
+            case SelectWrapper::Function_PcClothingModifier: return Dependency_Items;
+            case SelectWrapper::Function_Local: return Dependency_Locals;
+            case SelectWrapper::Function_NotLocal: return Dependency_Locals;
+            default: return 0;
+        }
+    }
+
+    void InfoIndex::addBucket (const Buckets& buckets, const std::string& id, std::vector<int>& indices)
+    {
+        Buckets::const_iterator iter = buckets.find (id);
+
+        if (iter!=buckets.end())
+            indices.insert (indices.end(), iter->second.begin(), iter->second.end());
+    }
+
+    void InfoIndex::getCandidates (const std::string& actorId, const std::string& race,
+        const std::string& npcClass, const std::string& faction, bool isCreature,
+        std::vector<const Entry *>& candidates) const
+    {
+        std::vector<int> indices;
+
+        addBucket (mByActor, actorId, indices);
+
+        // Creatures only get infos specific to their ID
+        if (!isCreature)
+        {
+            addBucket (mByRace, race, indices);
+            addBucket (mByClass, npcClass, indices);
+            if (!faction.empty())
+                addBucket (mByFaction, faction, indices);
+            indices.insert (indices.end(), mOther.begin(), mOther.end());
+
+            std::sort (indices.begin(), indices.end());
+        }
+
+        candidates.reserve (candidates.size() + indices.size());
+        for (std::vector<int>::const_iterator iter = indices.begin(); iter!=indices.end(); ++iter)
+            candidates.push_back (&mEntries[*iter]);
+    }
+
+    int InfoIndex::getDependencies() const
+    {
+        return mDependencies;
+    }
+
+    const InfoIndex& InfoIndexCache::get (const ESM::Dialogue& dialogue)
+    {
+        std::map<const ESM::Dialogue *, InfoIndex>::const_iterator iter = mIndices.find (&dialogue);
+
+        if (iter==mIndices.end())
+            iter = mIndices.insert (std::make_pair (&dialogue, InfoIndex (dialogue))).first;
+
+        return iter->second;
+    }
+
+    void InfoIndexCache::clear()
+    {
+        mIndices.clear();
+    }
+}
@@ -0,0 +1,96 @@
+#ifndef GAME_MWDIALOGUE_INFOINDEX_H
+#define GAME_MWDIALOGUE_INFOINDEX_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "selectwrapper.hpp"
+
+namespace ESM
+{
+    struct Dialogue;
+}
+
+namespace MWDialogue
+{
+    class InfoIndexCache;
+
+    /// \brief The infos of a dialogue, grouped by the filters that never change for a given actor.
+    ///
+    /// An info is filed under the first of actor ID, race, class and faction that it requires, so the infos
+    /// that can't possibly match an actor are skipped without looking at them. The candidates still have to
+    /// be checked with Filter, which also tests everything that is not indexed.
+    ///
+    /// The select structs of each info are decoded when the index is built.
+    class InfoIndex
+    {
+        public:
+
+            /// Kinds of game state that dialogue result scripts commonly change.
+            enum Dependency
+            {
+                Dependency_Journal = 1,
+                Dependency_Globals = 2,
+                Dependency_Items = 4, ///< player inventory
+                Dependency_Locals = 8 ///< local variables of scripts
+            };
+
+            struct Entry
+            {
+                const ESM::DialInfo *mInfo;
+                std::vector<SelectWrapper> mSelects;
+            };
+
+            /// Infos that might be used by an actor with the given lower case properties, in the order of
+            /// the dialogue.
+            /// \param race, npcClass, faction Ignored for creatures.
+            void getCandidates (const std::string& actorId, const std::string& race,
+                const std::string& npcClass, const std::string& faction, bool isCreature,
+                std::vector<const Entry *>& candidates) const;
+
+            /// Dependency flags of the kinds of state that the select structs of any info read.
+            ///
+            /// Filtering the dialogue for the same actor gives the same result as long as none of these and
+            /// nothing else but the state listed in Dependency changes.
+            int getDependencies() const;
+
+        private:
+
+            friend class InfoIndexCache;
+
+            explicit InfoIndex (const ESM::Dialogue& dialogue);
+
+            typedef std::map<std::string, std::vector<int> > Buckets; // indices into mEntries by lower case ID
+
+            std::vector<Entry> mEntries;
+            Buckets mByActor;
+            Buckets mByRace;
+            Buckets mByClass;
+            Buckets mByFaction;
+            std::vector<int> mOther; // no actor, race, class or faction required
+            int mDependencies;
+
+            static int getDependency (SelectWrapper::Function function);
+
+            static void addBucket (const Buckets& buckets, const std::string& id, std::vector<int>& indices);
+    };
+
+    /// \brief The InfoIndex of each dialogue, built on first use.
+    ///
+    /// Dialogue records must stay in place for the lifetime of the cache.
+    class InfoIndexCache
+    {
+        public:
+
+            const InfoIndex& get (const ESM::Dialogue& dialogue);
+
+            void clear();
+
+        private:
+
+            std::map<const ESM::Dialogue *, InfoIndex> mIndices;
+    };
+}
+
+#endif
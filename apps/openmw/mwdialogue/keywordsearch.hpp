@@ -241,7 +241,10 @@ private:
                 }
             }
             if (depth+1 == keyword.size())
-                j->second.mKeyword = value;
+            {
+                j->second.mValue = /*std::move*/ (value);
+                j->second.mKeyword = /*std::move*/ (keyword);
+            }
             else // depth+1 < keyword.size()
                 seed_impl (/*std::move*/ (keyword), /*std::move*/ (value), depth+1, j->second);
         }
@@ -27,30 +27,39 @@ namespace
         throw std::runtime_error ("unknown compare type in dialogue info select");
     }
 
-    template<typename T>
-    bool selectCompareImp (const ESM::DialInfo::SelectStruct& select, T value1)
+    int getFunctionIndex (const ESM::DialInfo::SelectStruct& select)
     {
-        if (select.mValue.getType()==ESM::VT_Int)
-        {
-            return selectCompareImp (select.mSelectRule[4], value1, select.mValue.getInteger());
-        }
-        else if (select.mValue.getType()==ESM::VT_Float)
-        {
-            return selectCompareImp (select.mSelectRule[4], value1, select.mValue.getFloat());
-        }
-        else
-            throw std::runtime_error (
-                "unsupported variable type in dialogue info select");
+        int index = 0;
+
+        if (select.mSelectRule.size()>2)
+            std::istringstream (select.mSelectRule.substr(2,2)) >> index;
+
+        return index;
     }
 }
 
-MWDialogue::SelectWrapper::Function MWDialogue::SelectWrapper::decodeFunction() const
+MWDialogue::SelectWrapper::Function MWDialogue::SelectWrapper::decodeFunction (const ESM::DialInfo::SelectStruct& select)
 {
-    int index = 0;
+    char type = select.mSelectRule.size()>1 ? select.mSelectRule[1] : '\0';
 
-    std::istringstream (mSelect.mSelectRule.substr(2,2)) >> index;
+    switch (type)
+    {
+        case '1': break;
+        case '2': return Function_Global;
+        case '3': return Function_Local;
+        case '4': return Function_Journal;
+        case '5': return Function_Item;
+        case '6': return Function_Dead;
+        case '7': return Function_NotId;
+        case '8': return Function_NotFaction;
+        case '9': return Function_NotClass;
+        case 'A': return Function_NotRace;
+        case 'B': return Function_NotCell;
+        case 'C': return Function_NotLocal;
+        default: return Function_None;
+    }
 
-    switch (index)
+    switch (getFunctionIndex (select))
     {
         case  0: return Function_RankLow;
         case  1: return Function_RankHigh;
@@ -97,39 +106,34 @@ MWDialogue::SelectWrapper::Function MWDialogue::SelectWrapper::decodeFunction()
     return Function_False;
 }
 
-MWDialogue::SelectWrapper::SelectWrapper (const ESM::DialInfo::SelectStruct& select) : mSelect (select) {}
-
-MWDialogue::SelectWrapper::Function MWDialogue::SelectWrapper::getFunction() const
+MWDialogue::SelectWrapper::SelectWrapper (const ESM::DialInfo::SelectStruct& select)
+: mFunction (decodeFunction (select)), mArgument (decodeArgument (select))
+, mComparison (select.mSelectRule.size()>4 ? select.mSelectRule[4] : '\0')
+, mValueType (select.mValue.getType()), mIntValue (0), mFloatValue (0)
 {
-    char type = mSelect.mSelectRule[1];
+    mType = decodeType();
+    mNpcOnly = decodeNpcOnly();
 
-    switch (type)
-    {
-        case '1': return decodeFunction();
-        case '2': return Function_Global;
-        case '3': return Function_Local;
-        case '4': return Function_Journal;
-        case '5': return Function_Item;
-        case '6': return Function_Dead;
-        case '7': return Function_NotId;
-        case '8': return Function_NotFaction;
-        case '9': return Function_NotClass;
-        case 'A': return Function_NotRace;
-        case 'B': return Function_NotCell;
-        case 'C': return Function_NotLocal;
-    }
+    if (mValueType==ESM::VT_Int)
+        mIntValue = select.mValue.getInteger();
+    else if (mValueType==ESM::VT_Float)
+        mFloatValue = select.mValue.getFloat();
 
-    return Function_None;
+    if (select.mSelectRule.size()>5)
+        mName = Misc::StringUtils::lowerCase (select.mSelectRule.substr (5));
 }
 
-int MWDialogue::SelectWrapper::getArgument() const
+MWDialogue::SelectWrapper::Function MWDialogue::SelectWrapper::getFunction() const
 {
-    if (mSelect.mSelectRule[1]!='1')
-        return 0;
+    return mFunction;
+}
 
-    int index = 0;
+int MWDialogue::SelectWrapper::decodeArgument (const ESM::DialInfo::SelectStruct& select)
+{
+    if (select.mSelectRule.size()<2 || select.mSelectRule[1]!='1')
+        return 0;
 
-    std::istringstream (mSelect.mSelectRule.substr(2,2)) >> index;
+    int index = getFunctionIndex (select);
 
     switch (index)
     {
@@ -187,7 +191,17 @@ int MWDialogue::SelectWrapper::getArgument() const
     return 0;
 }
 
+int MWDialogue::SelectWrapper::getArgument() const
+{
+    return mArgument;
+}
+
 MWDialogue::SelectWrapper::Type MWDialogue::SelectWrapper::getType() const
+{
+    return mType;
+}
+
+MWDialogue::SelectWrapper::Type MWDialogue::SelectWrapper::decodeType() const
 {
     static const Function integerFunctions[] =
     {
@@ -236,7 +250,7 @@ MWDialogue::SelectWrapper::Type MWDialogue::SelectWrapper::getType() const
         Function_None // end marker
     };
 
-    Function function = getFunction();
+    Function function = mFunction;
 
     for (int i=0; integerFunctions[i]!=Function_None; ++i)
         if (integerFunctions[i]==function)
@@ -258,6 +272,11 @@ MWDialogue::SelectWrapper::Type MWDialogue::SelectWrapper::getType() const
 }
 
 bool MWDialogue::SelectWrapper::isNpcOnly() const
+{
+    return mNpcOnly;
+}
+
+bool MWDialogue::SelectWrapper::decodeNpcOnly() const
 {
     static const Function functions[] =
     {
@@ -270,7 +289,7 @@ bool MWDialogue::SelectWrapper::isNpcOnly() const
         Function_None // end marker
     };
 
-    Function function = getFunction();
+    Function function = mFunction;
 
     for (int i=0; functions[i]!=Function_None; ++i)
         if (functions[i]==function)
@@ -279,22 +298,34 @@ bool MWDialogue::SelectWrapper::isNpcOnly() const
     return false;
 }
 
+template<typename T>
+bool MWDialogue::SelectWrapper::selectCompareImp (T value) const
+{
+    if (mValueType==ESM::VT_Int)
+        return ::selectCompareImp (mComparison, value, mIntValue);
+    else if (mValueType==ESM::VT_Float)
+        return ::selectCompareImp (mComparison, value, mFloatValue);
+    else
+        throw std::runtime_error (
+            "unsupported variable type in dialogue info select");
+}
+
 bool MWDialogue::SelectWrapper::selectCompare (int value) const
 {
-    return selectCompareImp (mSelect, value);
+    return selectCompareImp (value);
 }
 
 bool MWDialogue::SelectWrapper::selectCompare (float value) const
 {
-    return selectCompareImp (mSelect, value);
+    return selectCompareImp (value);
 }
 
 bool MWDialogue::SelectWrapper::selectCompare (bool value) const
 {
-    return selectCompareImp (mSelect, static_cast<int> (value));
+    return selectCompareImp (static_cast<int> (value));
 }
 
-std::string MWDialogue::SelectWrapper::getName() const
+const std::string& MWDialogue::SelectWrapper::getName() const
 {
-    return Misc::StringUtils::lowerCase (mSelect.mSelectRule.substr (5));
+    return mName;
 }
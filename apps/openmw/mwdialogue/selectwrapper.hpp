@@ -5,10 +5,9 @@
 
 namespace MWDialogue
 {
+    /// \brief A select struct of a dialogue info, decoded once so it can be evaluated repeatedly.
     class SelectWrapper
     {
-            const ESM::DialInfo::SelectStruct& mSelect;
-
         public:
 
             enum Function
@@ -57,7 +56,26 @@ namespace MWDialogue
 
         private:
 
-            Function decodeFunction() const;
+            Function mFunction;
+            Type mType;
+            int mArgument;
+            bool mNpcOnly;
+            char mComparison;
+            ESM::VarType mValueType;
+            int mIntValue;
+            float mFloatValue;
+            std::string mName; // lower case
+
+            static Function decodeFunction (const ESM::DialInfo::SelectStruct& select);
+
+            static int decodeArgument (const ESM::DialInfo::SelectStruct& select);
+
+            Type decodeType() const;
+
+            bool decodeNpcOnly() const;
+
+            template<typename T>
+            bool selectCompareImp (T value) const;
 
         public:
 
@@ -78,7 +96,7 @@ namespace MWDialogue
 
             bool selectCompare (bool value) const;
 
-            std::string getName() const;
+            const std::string& getName() const;
             ///< Return case-smashed name.
     };
 }
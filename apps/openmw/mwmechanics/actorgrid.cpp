@@ -0,0 +1,183 @@
+#include "actorgrid.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace MWMechanics
+{
+    size_t ActorGrid::CellIndexHash::operator()(const CellIndex& index) const
+    {
+        return static_cast<size_t>(index.first) * 73856093u ^ static_cast<size_t>(index.second) * 19349663u;
+    }
+
+    ActorGrid::ActorGrid(float cellSize)
+        : mCellSize(cellSize)
+    {
+    }
+
+    void ActorGrid::clear()
+    {
+        mCells.clear();
+        mCellIndices.clear();
+    }
+
+    int ActorGrid::getCellCoordinate(float value) const
+    {
+        return static_cast<int>(std::floor(value / mCellSize));
+    }
+
+    ActorGrid::CellIndex ActorGrid::getCellIndex(const osg::Vec3f& position) const
+    {
+        return CellIndex(getCellCoordinate(position.x()), getCellCoordinate(position.y()));
+    }
+
+    std::vector<ActorGrid::Entry>::iterator ActorGrid::findEntry(std::vector<Entry>& cell, const MWWorld::Ptr& ptr)
+    {
+        std::vector<Entry>::iterator it = cell.begin();
+        for (; it != cell.end(); ++it)
+        {
+            if (it->mPtr == ptr)
+                break;
+        }
+        return it;
+    }
+
+    void ActorGrid::eraseEntry(const CellIndex& index, const MWWorld::Ptr& ptr)
+    {
+        CellMap::iterator found = mCells.find(index);
+        if (found == mCells.end())
+            return;
+
+        std::vector<Entry>& cell = found->second;
+        std::vector<Entry>::iterator it = findEntry(cell, ptr);
+        if (it != cell.end())
+        {
+            *it = cell.back();
+            cell.pop_back();
+        }
+
+        if (cell.empty())
+            mCells.erase(found);
+    }
+
+    void ActorGrid::insert(const MWWorld::Ptr& ptr, const osg::Vec3f& position)
+    {
+        if (mCellIndices.find(ptr) != mCellIndices.end())
+        {
+            update(ptr, position);
+            return;
+        }
+
+        Entry entry;
+        entry.mPtr = ptr;
+        entry.mPosition = position;
+
+        const CellIndex index = getCellIndex(position);
+        mCells[index].push_back(entry);
+        mCellIndices[ptr] = index;
+    }
+
+    void ActorGrid::remove(const MWWorld::Ptr& ptr)
+    {
+        std::map<MWWorld::Ptr, CellIndex>::iterator found = mCellIndices.find(ptr);
+        if (found == mCellIndices.end())
+            return;
+
+        eraseEntry(found->second, ptr);
+        mCellIndices.erase(found);
+    }
+
+    void ActorGrid::update(const MWWorld::Ptr& ptr, const osg::Vec3f& position)
+    {
+        std::map<MWWorld::Ptr, CellIndex>::iterator found = mCellIndices.find(ptr);
+        if (found == mCellIndices.end())
+            return;
+
+        const CellIndex index = getCellIndex(position);
+        if (index == found->second)
+        {
+            std::vector<Entry>& cell = mCells[index];
+            std::vector<Entry>::iterator it = findEntry(cell, ptr);
+            if (it != cell.end())
+                it->mPosition = position;
+            return;
+        }
+
+        eraseEntry(found->second, ptr);
+
+        Entry entry;
+        entry.mPtr = ptr;
+        entry.mPosition = position;
+        mCells[index].push_back(entry);
+        found->second = index;
+    }
+
+    void ActorGrid::updatePtr(const MWWorld::Ptr& old, const MWWorld::Ptr& ptr)
+    {
+        std::map<MWWorld::Ptr, CellIndex>::iterator found = mCellIndices.find(old);
+        if (found == mCellIndices.end())
+            return;
+
+        const CellIndex index = found->second;
+        mCellIndices.erase(found);
+
+        std::vector<Entry>& cell = mCells[index];
+        std::vector<Entry>::iterator it = findEntry(cell, old);
+        if (it != cell.end())
+            it->mPtr = ptr;
+        mCellIndices[ptr] = index;
+    }
+
+    void ActorGrid::queryCell(const std::vector<Entry>& cell, const osg::Vec3f& position, float sqrRadius,
+                              std::vector<MWWorld::Ptr>& out) const
+    {
+        for (std::vector<Entry>::const_iterator it = cell.begin(); it != cell.end(); ++it)
+        {
+            if ((it->mPosition - position).length2() <= sqrRadius)
+                out.push_back(it->mPtr);
+        }
+    }
+
+    void ActorGrid::query(const osg::Vec3f& position, float radius, std::vector<MWWorld::Ptr>& out) const
+    {
+        if (mCells.empty())
+            return;
+
+        const size_t first = out.size();
+        const float sqrRadius = radius * radius;
+
+        const int cellMinX = getCellCoordinate(position.x() - radius);
+        const int cellMaxX = getCellCoordinate(position.x() + radius);
+        const int cellMinY = getCellCoordinate(position.y() - radius);
+        const int cellMaxY = getCellCoordinate(position.y() + radius);
+
+        const double cellCount = (static_cast<double>(cellMaxX) - cellMinX + 1) * (static_cast<double>(cellMaxY) - cellMinY + 1);
+
+        if (cellCount > static_cast<double>(mCells.size()))
+        {
+            // Probing every bucket of a large area would mostly hit empty ones, so only look at the occupied
+            // buckets instead and skip those outside of the area
+            for (CellMap::const_iterator it = mCells.begin(); it != mCells.end(); ++it)
+            {
+                if (it->first.first < cellMinX || it->first.first > cellMaxX
+                        || it->first.second < cellMinY || it->first.second > cellMaxY)
+                    continue;
+                queryCell(it->second, position, sqrRadius, out);
+            }
+        }
+        else
+        {
+            for (int x = cellMinX; x <= cellMaxX; ++x)
+            {
+                for (int y = cellMinY; y <= cellMaxY; ++y)
+                {
+                    CellMap::const_iterator found = mCells.find(CellIndex(x, y));
+                    if (found != mCells.end())
+                        queryCell(found->second, position, sqrRadius, out);
+                }
+            }
+        }
+
+        std::sort(out.begin() + first, out.end());
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef OPENMW_MECHANICS_ACTORGRID_H
+#define OPENMW_MECHANICS_ACTORGRID_H
+
+#include <cstddef>
+#include <map>
+#include <vector>
+#include <unordered_map>
+
+#include <osg/Vec3f>
+
+#include "../mwworld/ptr.hpp"
+
+namespace MWMechanics
+{
+    /// @brief Uniform 2D hash grid over actor positions, used to narrow down proximity queries.
+    /// @note The owner has to keep the grid up to date by calling update() whenever an actor is moved.
+    class ActorGrid
+    {
+    public:
+        ActorGrid(float cellSize);
+
+        /// Remove all actors.
+        void clear();
+
+        /// Add \a ptr at \a position, or move it there if it is already in the grid.
+        void insert(const MWWorld::Ptr& ptr, const osg::Vec3f& position);
+
+        /// @note Ignored if \a ptr is not in the grid.
+        void remove(const MWWorld::Ptr& ptr);
+
+        /// Move \a ptr to \a position.
+        /// @note Ignored if \a ptr is not in the grid.
+        void update(const MWWorld::Ptr& ptr, const osg::Vec3f& position);
+
+        /// Replace \a old by \a ptr, keeping its position.
+        /// @note Ignored if \a old is not in the grid.
+        void updatePtr(const MWWorld::Ptr& old, const MWWorld::Ptr& ptr);
+
+        /// Append actors whose position lies within \a radius of \a position to \a out, in ascending Ptr order
+        /// (i.e. the iteration order of a std::map keyed by Ptr).
+        void query(const osg::Vec3f& position, float radius, std::vector<MWWorld::Ptr>& out) const;
+
+    private:
+        struct Entry
+        {
+            MWWorld::Ptr mPtr;
+            osg::Vec3f mPosition;
+        };
+
+        typedef std::pair<int, int> CellIndex;
+
+        struct CellIndexHash
+        {
+            size_t operator()(const CellIndex& index) const;
+        };
+
+        typedef std::unordered_map<CellIndex, std::vector<Entry>, CellIndexHash> CellMap;
+
+        int getCellCoordinate(float value) const;
+
+        CellIndex getCellIndex(const osg::Vec3f& position) const;
+
+        std::vector<Entry>::iterator findEntry(std::vector<Entry>& cell, const MWWorld::Ptr& ptr);
+
+        void eraseEntry(const CellIndex& index, const MWWorld::Ptr& ptr);
+        ///< Remove \a ptr from the bucket at \a index and drop the bucket once it is empty.
+
+        void queryCell(const std::vector<Entry>& cell, const osg::Vec3f& position, float sqrRadius,
+                       std::vector<MWWorld::Ptr>& out) const;
+
+        float mCellSize;
+
+        CellMap mCells; ///< Only occupied buckets
+        std::map<MWWorld::Ptr, CellIndex> mCellIndices;
+    };
+}
+
+#endif
@@ -1,13 +1,17 @@
 #include "actors.hpp"
 
+#include <algorithm>
 #include <typeinfo>
 #include <iostream>
 
+#include <osg/Timer>
+
 #include <components/esm/esmreader.hpp>
 #include <components/esm/esmwriter.hpp>
 #include <components/esm/loadnpc.hpp>
 
 #include <components/sceneutil/positionattitudetransform.hpp>
+#include <components/sceneutil/workqueue.hpp>
 
 #include <components/settings/settings.hpp>
 
@@ -152,6 +156,19 @@ void getRestorationPerHourOfSleep (const MWWorld::Ptr& ptr, float& health, float
     }
 }
 
+float getMaxHeadTrackDistance (const MWWorld::Ptr& actor)
+{
+    static const float fMaxHeadTrackDistance = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>()
+            .find("fMaxHeadTrackDistance")->getFloat();
+    static const float fInteriorHeadTrackMult = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>()
+            .find("fInteriorHeadTrackMult")->getFloat();
+    float maxDistance = fMaxHeadTrackDistance;
+    const ESM::Cell* currentCell = actor.getCell()->getCell();
+    if (!currentCell->isExterior() && !(currentCell->mData.mFlags & ESM::Cell::QuasiEx))
+        maxDistance *= fInteriorHeadTrackMult;
+    return maxDistance;
+}
+
 }
 
 namespace MWMechanics
@@ -169,6 +186,14 @@ namespace MWMechanics
     */
     const float sqrAiProcessingDistance = aiProcessingDistance*aiProcessingDistance;
 
+    // Bucket size of the grid used for proximity queries between actors
+    const float actorGridCellSize = 1024.f;
+
+    // Actors further apart than this don't engage each other in combat. This is the original AI processing distance;
+    // the multiplayer one above only decides which actors run their AI, and as a pairing radius it would cover every actor
+    const float actorEngageDistance = 7168;
+    const float sqrActorEngageDistance = actorEngageDistance*actorEngageDistance;
+
     class SoulTrap : public MWMechanics::EffectSourceVisitor
     {
         MWWorld::Ptr mCreature;
@@ -265,14 +290,7 @@ namespace MWMechanics
     void Actors::updateHeadTracking(const MWWorld::Ptr& actor, const MWWorld::Ptr& targetActor,
                                     MWWorld::Ptr& headTrackTarget, float& sqrHeadTrackDistance)
     {
-        static const float fMaxHeadTrackDistance = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>()
-                .find("fMaxHeadTrackDistance")->getFloat();
-        static const float fInteriorHeadTrackMult = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>()
-                .find("fInteriorHeadTrackMult")->getFloat();
-        float maxDistance = fMaxHeadTrackDistance;
-        const ESM::Cell* currentCell = actor.getCell()->getCell();
-        if (!currentCell->isExterior() && !(currentCell->mData.mFlags & ESM::Cell::QuasiEx))
-            maxDistance *= fInteriorHeadTrackMult;
+        const float maxDistance = getMaxHeadTrackDistance(actor);
 
         const ESM::Position& actor1Pos = actor.getRefData().getPosition();
         const ESM::Position& actor2Pos = targetActor.getRefData().getPosition();
@@ -317,7 +335,7 @@ namespace MWMechanics
         const ESM::Position& actor1Pos = actor1.getRefData().getPosition();
         const ESM::Position& actor2Pos = actor2.getRefData().getPosition();
         float sqrDist = (actor1Pos.asVec3() - actor2Pos.asVec3()).length2();
-        if (sqrDist > sqrAiProcessingDistance)
+        if (sqrDist > sqrActorEngageDistance)
             return;
 
         // No combat for totally static creatures
@@ -1058,7 +1076,19 @@ namespace MWMechanics
         }
     }
 
-    Actors::Actors() {}
+    Actors::Actors()
+        : mActorGrid(actorGridCellSize)
+        , mNumThinkThreads(0)
+    {
+        mAiScheduler.setBudget(Settings::Manager::getFloat("ai update budget", "Game") / 1000.f);
+
+        int numThinkThreads = Settings::Manager::getInt("ai threads", "Game");
+        if (numThinkThreads > 0)
+        {
+            mNumThinkThreads = numThinkThreads;
+            mThinkWorkQueue = new SceneUtil::WorkQueue(numThinkThreads);
+        }
+    }
 
     Actors::~Actors()
     {
@@ -1073,6 +1103,7 @@ namespace MWMechanics
         if (!anim)
             return;
         mActors.insert(std::make_pair(ptr, new Actor(ptr, anim)));
+        mActorGrid.insert(ptr, ptr.getRefData().getPosition().asVec3());
         if (updateImmediately)
             mActors[ptr]->getCharacterController()->update(0);
     }
@@ -1082,6 +1113,7 @@ namespace MWMechanics
         PtrActorMap::iterator iter = mActors.find(ptr);
         if(iter != mActors.end())
         {
+            mActorGrid.remove(ptr);
             delete iter->second;
             mActors.erase(iter);
         }
@@ -1092,6 +1124,8 @@ namespace MWMechanics
         PtrActorMap::iterator iter = mActors.find(old);
         if(iter != mActors.end())
         {
+            mActorGrid.updatePtr(old, ptr);
+
             Actor *actor = iter->second;
             mActors.erase(iter);
 
@@ -1107,6 +1141,7 @@ namespace MWMechanics
         {
             if((iter->first.isInCell() && iter->first.getCell()==cellStore) && iter->first != ignore)
             {
+                mActorGrid.remove(iter->first);
                 delete iter->second;
                 mActors.erase(iter++);
             }
@@ -1119,16 +1154,6 @@ namespace MWMechanics
     {
         if(!paused)
         {
-            static float timerUpdateAITargets = 0;
-            static float timerUpdateHeadTrack = 0;
-            static float timerUpdateEquippedLight = 0;
-            const float updateEquippedLightInterval = 1.0f;
-
-            // target lists get updated once every 1.0 sec
-            if (timerUpdateAITargets >= 1.0f) timerUpdateAITargets = 0;
-            if (timerUpdateHeadTrack >= 0.3f) timerUpdateHeadTrack = 0;
-            if (timerUpdateEquippedLight >= updateEquippedLightInterval) timerUpdateEquippedLight = 0;
-
             MWWorld::Ptr player = getPlayer();
 
             int hostilesCount = 0; // need to know this to play Battle music
@@ -1137,6 +1162,12 @@ namespace MWMechanics
 
             std::map<const MWWorld::Ptr, const std::set<MWWorld::Ptr> > cachedAllies; // will be filled as engageCombat iterates
 
+            std::vector<MWWorld::Ptr> neighbours;
+
+            thinkInParallel(duration);
+
+            scheduleAiTasks(duration);
+
              // AI and magic effects update
             for(PtrActorMap::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
             {
@@ -1219,14 +1250,13 @@ namespace MWMechanics
 
                 if (!iter->first.getClass().getCreatureStats(iter->first).isDead())
                 {
+                    const int actorId = iter->first.getClass().getCreatureStats(iter->first).getActorId();
                     bool cellChanged = MWBase::Environment::get().getWorld()->hasCellChanged();
                     MWWorld::Ptr actor = iter->first; // make a copy of the map key to avoid it being invalidated when the player teleports
                     updateActor(actor, duration);
                     if (!cellChanged && MWBase::Environment::get().getWorld()->hasCellChanged())
-                    {
                         return; // for now abort update of the old cell when cell changes by teleportation magic effect
                                 // a better solution might be to apply cell changes at the end of the frame
-                    }
 
                     /*
                         Start of tes3mp change (major)
@@ -1241,30 +1271,47 @@ namespace MWMechanics
 
                     if (inProcessingRange && (isAIActive || isLocalActor || isDedicatedActor))
                     {
-                        if (timerUpdateAITargets == 0 && (isLocalActor || isAIActive))
+                        if (mAiScheduler.isScheduled(actorId, AiScheduler::Task_UpdateTargets) && (isLocalActor || isAIActive))
                         {
+                            osg::Timer_t startTick = osg::Timer::instance()->tick();
+
                             if (iter->first != player)
                                 adjustCommandedActor(iter->first);
 
-                            for(PtrActorMap::iterator it(mActors.begin()); it != mActors.end(); ++it)
+                            if (iter->first != player) // player is not AI-controlled
                             {
-                                if (it->first == iter->first || iter->first == player) // player is not AI-controlled
-                                    continue;
-                                engageCombat(iter->first, it->first, cachedAllies, it->first == player);
+                                neighbours.clear();
+                                getObjectsInRange(iter->first.getRefData().getPosition().asVec3(), actorEngageDistance, neighbours);
+                                for(std::vector<MWWorld::Ptr>::const_iterator it(neighbours.begin()); it != neighbours.end(); ++it)
+                                {
+                                    if (*it == iter->first)
+                                        continue;
+                                    engageCombat(iter->first, *it, cachedAllies, *it == player);
+                                }
                             }
+
+                            mAiScheduler.addCost(AiScheduler::Task_UpdateTargets,
+                                                 osg::Timer::instance()->delta_s(startTick, osg::Timer::instance()->tick()));
                         }
-                        if (timerUpdateHeadTrack == 0)
+                        if (mAiScheduler.isScheduled(actorId, AiScheduler::Task_HeadTracking))
                         {
+                            osg::Timer_t startTick = osg::Timer::instance()->tick();
+
                             float sqrHeadTrackDistance = std::numeric_limits<float>::max();
                             MWWorld::Ptr headTrackTarget;
 
-                            for(PtrActorMap::iterator it(mActors.begin()); it != mActors.end(); ++it)
+                            neighbours.clear();
+                            getObjectsInRange(iter->first.getRefData().getPosition().asVec3(), getMaxHeadTrackDistance(iter->first), neighbours);
+                            for(std::vector<MWWorld::Ptr>::const_iterator it(neighbours.begin()); it != neighbours.end(); ++it)
                             {
-                                if (it->first == iter->first)
+                                if (*it == iter->first)
                                     continue;
-                                updateHeadTracking(iter->first, it->first, headTrackTarget, sqrHeadTrackDistance);
+                                updateHeadTracking(iter->first, *it, headTrackTarget, sqrHeadTrackDistance);
                             }
                             iter->second->getCharacterController()->setHeadTrackTarget(headTrackTarget);
+
+                            mAiScheduler.addCost(AiScheduler::Task_HeadTracking,
+                                                 osg::Timer::instance()->delta_s(startTick, osg::Timer::instance()->tick()));
                         }
 
                         if (iter->first.getClass().isNpc() && iter->first != player && (isLocalActor || isAIActive))
@@ -1287,16 +1334,19 @@ namespace MWMechanics
                     {
                         updateNpc(iter->first, duration);
 
-                        if (timerUpdateEquippedLight == 0)
-                            updateEquippedLight(iter->first, updateEquippedLightInterval);
+                        if (mAiScheduler.isScheduled(actorId, AiScheduler::Task_EquippedLight))
+                        {
+                            osg::Timer_t startTick = osg::Timer::instance()->tick();
+
+                            updateEquippedLight(iter->first, mAiScheduler.getElapsed(actorId, AiScheduler::Task_EquippedLight));
+
+                            mAiScheduler.addCost(AiScheduler::Task_EquippedLight,
+                                                 osg::Timer::instance()->delta_s(startTick, osg::Timer::instance()->tick()));
+                        }
                     }
                 }
             }
 
-            timerUpdateAITargets += duration;
-            timerUpdateHeadTrack += duration;
-            timerUpdateEquippedLight += duration;
-
             // Looping magic VFX update
             // Note: we need to do this before any of the animations are updated.
             // Reaching the text keys may trigger Hit / Spellcast (and as such, particles),
@@ -1699,13 +1749,153 @@ namespace MWMechanics
             iter->second->getCharacterController()->persistAnimationState();
     }
 
-    void Actors::getObjectsInRange(const osg::Vec3f& position, float radius, std::vector<MWWorld::Ptr>& out)
+    /// Runs AiSequence::think for a range of actors.
+    class ThinkWorkItem : public SceneUtil::WorkItem
     {
-        for (PtrActorMap::iterator iter = mActors.begin(); iter != mActors.end(); ++iter)
+    public:
+        ThinkWorkItem(const std::vector<std::pair<MWWorld::Ptr, Actor*> >& actors, size_t begin, size_t end)
+            : mActors(actors)
+            , mBegin(begin)
+            , mEnd(end)
+        {
+        }
+
+        virtual void doWork()
+        {
+            for (size_t i=mBegin; i<mEnd; ++i)
+            {
+                const MWWorld::Ptr& ptr = mActors[i].first;
+                try
+                {
+                    ptr.getClass().getCreatureStats(ptr).getAiSequence().think(ptr, mActors[i].second->getAiState());
+                }
+                catch (std::exception& e)
+                {
+                    // A failed think only means execute() has to decide by itself, so just report the first one
+                    if (mError.empty())
+                        mError = e.what();
+                }
+            }
+        }
+
+        std::string mError;
+
+    private:
+        const std::vector<std::pair<MWWorld::Ptr, Actor*> >& mActors;
+        size_t mBegin;
+        size_t mEnd;
+    };
+
+    void Actors::thinkInParallel(float duration)
+    {
+        if (!mThinkWorkQueue)
+            return;
+
+        MWWorld::Ptr player = getPlayer();
+        const osg::Vec3f playerPos = player.getRefData().getPosition().asVec3();
+        const bool isAIActive = MWBase::Environment::get().getMechanicsManager()->isAIActive();
+
+        // Mirrors the conditions under which the AI update executes an actor's AiSequence
+        mThinkingActors.clear();
+        for (PtrActorMap::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
+        {
+            const MWWorld::Ptr& ptr = iter->first;
+            if (ptr == player || (playerPos - ptr.getRefData().getPosition().asVec3()).length2() > sqrAiProcessingDistance)
+                continue;
+
+            /*
+                Start of tes3mp addition
+
+                Only local actors run their AI when the AI is not active
+            */
+            if (!isAIActive && !mwmp::Main::get().getCellController()->isLocalActor(ptr))
+                continue;
+            /*
+                End of tes3mp addition
+            */
+
+            CreatureStats& stats = ptr.getClass().getCreatureStats(ptr);
+            if (stats.isDead() || !isConscious(ptr))
+                continue;
+
+            if (stats.getAiSequence().prepareThink(ptr, *iter->second->getCharacterController(), iter->second->getAiState(), duration))
+                mThinkingActors.push_back(std::make_pair(ptr, iter->second));
+        }
+
+        if (mThinkingActors.empty())
+            return;
+
+        // The calling thread thinks for the last chunk itself instead of idling
+        const size_t numChunks = std::min(mThinkingActors.size(), static_cast<size_t>(mNumThinkThreads) + 1);
+
+        std::vector<osg::ref_ptr<ThinkWorkItem> > items;
+        items.reserve(numChunks);
+        for (size_t chunk=0; chunk<numChunks; ++chunk)
         {
-            if ((iter->first.getRefData().getPosition().asVec3() - position).length2() <= radius*radius)
-                out.push_back(iter->first);
+            size_t begin = mThinkingActors.size() * chunk / numChunks;
+            size_t end = mThinkingActors.size() * (chunk+1) / numChunks;
+            items.push_back(new ThinkWorkItem(mThinkingActors, begin, end));
         }
+
+        for (size_t chunk=0; chunk+1<numChunks; ++chunk)
+            mThinkWorkQueue->addWorkItem(items[chunk], true);
+        items.back()->doWork();
+
+        for (size_t chunk=0; chunk+1<numChunks; ++chunk)
+            items[chunk]->waitTillDone();
+
+        for (std::vector<osg::ref_ptr<ThinkWorkItem> >::const_iterator it = items.begin(); it != items.end(); ++it)
+        {
+            if (!(*it)->mError.empty())
+                std::cerr << "Error during AiSequence::think: " << (*it)->mError << std::endl;
+        }
+    }
+
+    void Actors::scheduleAiTasks(float duration)
+    {
+        mAiScheduler.beginFrame(duration);
+
+        MWWorld::Ptr player = getPlayer();
+        const osg::Vec3f playerPos = player.getRefData().getPosition().asVec3();
+
+        for (PtrActorMap::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
+        {
+            const MWWorld::Ptr& ptr = iter->first;
+            CreatureStats& stats = ptr.getClass().getCreatureStats(ptr);
+            if (stats.isDead())
+                continue;
+
+            const float sqrDistance = (playerPos - ptr.getRefData().getPosition().asVec3()).length2();
+
+            int tasks = 0;
+            if (sqrDistance <= sqrAiProcessingDistance)
+            {
+                tasks |= 1 << AiScheduler::Task_HeadTracking;
+                if (ptr != player)
+                    tasks |= 1 << AiScheduler::Task_UpdateTargets;
+            }
+            if (ptr.getTypeName() == typeid(ESM::NPC).name())
+                tasks |= 1 << AiScheduler::Task_EquippedLight;
+
+            mAiScheduler.addActor(stats.getActorId(), tasks, stats.getAiSequence().isInCombat(), sqrDistance);
+        }
+
+        mAiScheduler.schedule();
+    }
+
+    void Actors::reportStats(unsigned int frameNumber, osg::Stats* stats) const
+    {
+        mAiScheduler.reportStats(frameNumber, stats);
+    }
+
+    void Actors::updatePosition(const MWWorld::Ptr& ptr)
+    {
+        mActorGrid.update(ptr, ptr.getRefData().getPosition().asVec3());
+    }
+
+    void Actors::getObjectsInRange(const osg::Vec3f& position, float radius, std::vector<MWWorld::Ptr>& out)
+    {
+        mActorGrid.query(position, radius, out);
     }
 
     std::list<MWWorld::Ptr> Actors::getActorsSidingWith(const MWWorld::Ptr& actor)
@@ -1908,6 +2098,7 @@ namespace MWMechanics
             it->second = NULL;
         }
         mActors.clear();
+        mActorGrid.clear();
         mDeathCount.clear();
     }
 
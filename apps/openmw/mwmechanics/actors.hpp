@@ -7,9 +7,13 @@
 #include <map>
 #include <list>
 
+#include <osg/ref_ptr>
+
 #include "../mwbase/world.hpp"
 
 #include "movement.hpp"
+#include "actorgrid.hpp"
+#include "aischeduler.hpp"
 
 namespace MWWorld
 {
@@ -17,6 +21,11 @@ namespace MWWorld
     class CellStore;
 }
 
+namespace SceneUtil
+{
+    class WorkQueue;
+}
+
 namespace MWMechanics
 {
     class Actor;
@@ -45,6 +54,13 @@ namespace MWMechanics
 
             void killDeadActors ();
 
+            void scheduleAiTasks(float duration);
+            ///< Decide which actors run their periodic AI tasks (target and head tracking updates, equipped lights) this frame
+
+            void thinkInParallel(float duration);
+            ///< Let the AI packages of the actors that are about to be executed do their read-only decision making
+            /// on the worker threads, ahead of the serial AI update.
+
             void purgeSpellEffects (int casterActorId);
 
         public:
@@ -74,6 +90,11 @@ namespace MWMechanics
             void updateActor(const MWWorld::Ptr &old, const MWWorld::Ptr& ptr);
             ///< Updates an actor with a new Ptr
 
+            void updatePosition(const MWWorld::Ptr& ptr);
+            ///< Update the position of an actor for getObjectsInRange after it has been moved
+            ///
+            /// \note Ignored, if \a ptr is not a registered actor.
+
             void dropActors (const MWWorld::CellStore *cellStore, const MWWorld::Ptr& ignore);
             ///< Deregister all actors (except for \a ignore) in the given cell.
 
@@ -125,6 +146,7 @@ namespace MWMechanics
         void persistAnimationStates();
 
             void getObjectsInRange(const osg::Vec3f& position, float radius, std::vector<MWWorld::Ptr>& out);
+            ///< Append actors within \a radius of \a position to \a out, in the order they are stored in.
 
             void cleanupSummonedCreature (CreatureStats& casterStats, int creatureActorId);
 
@@ -158,8 +180,17 @@ namespace MWMechanics
 
             bool isReadyToBlock(const MWWorld::Ptr& ptr) const;
 
+            void reportStats(unsigned int frameNumber, osg::Stats* stats) const;
+            ///< Report how many periodic AI tasks ran and were deferred in the last update
+
     private:
         PtrActorMap mActors;
+        ActorGrid mActorGrid;
+        AiScheduler mAiScheduler;
+
+        osg::ref_ptr<SceneUtil::WorkQueue> mThinkWorkQueue;
+        unsigned int mNumThinkThreads;
+        std::vector<std::pair<MWWorld::Ptr, Actor*> > mThinkingActors;
 
     };
 }
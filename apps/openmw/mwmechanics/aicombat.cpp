@@ -62,6 +62,8 @@ namespace MWMechanics
         const MWWorld::CellStore* mCell;
         std::shared_ptr<Action> mCurrentAction;
         float mActionCooldown;
+        std::shared_ptr<Action> mNextAction; // selected by AiCombat::think() against mNextActionTarget
+        MWWorld::Ptr mNextActionTarget;
         float mStrength;
         bool mForceNoShortcut;
         ESM::Position mShortcutFailPos;
@@ -92,6 +94,8 @@ namespace MWMechanics
         mCell(NULL),
         mCurrentAction(),
         mActionCooldown(0.0f),
+        mNextAction(),
+        mNextActionTarget(),
         mStrength(),
         mForceNoShortcut(false),
         mShortcutFailPos(),
@@ -180,6 +184,12 @@ namespace MWMechanics
     {
         // get or create temporary storage
         AiCombatStorage& storage = state.get<AiCombatStorage>();
+
+        // Whatever think() selected is only meant for this frame
+        std::shared_ptr<Action> nextAction;
+        nextAction.swap(storage.mNextAction);
+        MWWorld::Ptr nextActionTarget = storage.mNextActionTarget;
+        storage.mNextActionTarget = MWWorld::Ptr();
         
         //General description
         if (actor.getClass().getCreatureStats(actor).isDead())
@@ -243,14 +253,51 @@ namespace MWMechanics
         else
         {
             timerReact = 0;
-            if (attack(actor, target, storage, characterController))
+            if (nextActionTarget != target)
+                nextAction.reset();
+            if (attack(actor, target, storage, characterController, nextAction))
                 return true;
         }
 
         return false;
     }
 
-    bool AiCombat::attack(const MWWorld::Ptr& actor, const MWWorld::Ptr& target, AiCombatStorage& storage, CharacterController& characterController)
+    bool AiCombat::prepareThink(const MWWorld::Ptr& actor, const CharacterController& characterController, AiState& state, float duration)
+    {
+        AiCombatStorage& storage = state.get<AiCombatStorage>();
+        storage.mNextAction.reset();
+        storage.mNextActionTarget = MWWorld::Ptr();
+
+        // Only think if execute() is going to ask attack() for a new action this frame
+        if (storage.mTimerReact < AI_REACTION_TIME || storage.mActionCooldown - duration > 0
+                || !characterController.readyToPrepareAttack())
+            return false;
+
+        if (actor.getClass().getCreatureStats(actor).isDead())
+            return false;
+
+        MWWorld::Ptr target = getTarget();
+        if (target.isEmpty() || !target.getRefData().getCount() || !target.getRefData().isEnabled()
+                || target.getClass().getCreatureStats(target).isDead())
+            return false;
+
+        // Container weights are cached lazily, so compute them before anybody starts thinking
+        actor.getClass().getEncumbrance(actor);
+        target.getClass().getEncumbrance(target);
+
+        storage.mNextActionTarget = target;
+        return true;
+    }
+
+    void AiCombat::think(const MWWorld::Ptr& actor, AiState& state) const
+    {
+        AiCombatStorage& storage = state.get<AiCombatStorage>();
+        if (!storage.mNextActionTarget.isEmpty())
+            storage.mNextAction = selectNextAction(actor, storage.mNextActionTarget);
+    }
+
+    bool AiCombat::attack(const MWWorld::Ptr& actor, const MWWorld::Ptr& target, AiCombatStorage& storage, CharacterController& characterController,
+                          const std::shared_ptr<Action>& nextAction)
     {
         const MWWorld::CellStore*& currentCell = storage.mCell;
         bool cellChange = currentCell && (actor.getCell() != currentCell);
@@ -326,7 +373,13 @@ namespace MWMechanics
 
             if (characterController.readyToPrepareAttack())
             {
-                currentAction = prepareNextAction(actor, target);
+                if (nextAction)
+                {
+                    currentAction = nextAction;
+                    currentAction->prepare(actor);
+                }
+                else
+                    currentAction = prepareNextAction(actor, target);
                 actionCooldown = currentAction->getActionCooldown();
             }
         }
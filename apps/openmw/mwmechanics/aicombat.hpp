@@ -1,6 +1,8 @@
 #ifndef GAME_MWMECHANICS_AICOMBAT_H
 #define GAME_MWMECHANICS_AICOMBAT_H
 
+#include <memory>
+
 #include "aipackage.hpp"
 
 #include "../mwworld/cellstore.hpp" // for Doors
@@ -41,6 +43,11 @@ namespace MWMechanics
 
             virtual bool execute (const MWWorld::Ptr& actor, CharacterController& characterController, AiState& state, float duration);
 
+            virtual bool prepareThink (const MWWorld::Ptr& actor, const CharacterController& characterController, AiState& state, float duration);
+
+            /// Selects the next combat action, if execute() will need one this frame.
+            virtual void think (const MWWorld::Ptr& actor, AiState& state) const;
+
             virtual int getTypeId() const;
 
             virtual unsigned int getPriority() const;
@@ -58,7 +65,9 @@ namespace MWMechanics
             int mTargetActorId;
 
             /// Returns true if combat should end
-            bool attack(const MWWorld::Ptr& actor, const MWWorld::Ptr& target, AiCombatStorage& storage, CharacterController& characterController);
+            /// @param nextAction Action selected by think() for this target, may be empty
+            bool attack(const MWWorld::Ptr& actor, const MWWorld::Ptr& target, AiCombatStorage& storage, CharacterController& characterController,
+                        const std::shared_ptr<Action>& nextAction);
 
             void updateLOS(const MWWorld::Ptr& actor, const MWWorld::Ptr& target, float duration, AiCombatStorage& storage);
 
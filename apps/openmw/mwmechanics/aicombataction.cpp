@@ -722,19 +722,16 @@ namespace MWMechanics
         return mWeapon.get<ESM::Weapon>()->mBase;
     }
 
-    std::shared_ptr<Action> prepareNextAction(const MWWorld::Ptr &actor, const MWWorld::Ptr &enemy)
+    std::shared_ptr<Action> selectNextAction(const MWWorld::Ptr &actor, const MWWorld::Ptr &enemy)
     {
-        Spells& spells = actor.getClass().getCreatureStats(actor).getSpells();
+        const Spells& spells = actor.getClass().getCreatureStats(actor).getSpells();
 
         float bestActionRating = 0.f;
         float antiFleeRating = 0.f;
         // Default to hand-to-hand combat
         std::shared_ptr<Action> bestAction (new ActionWeapon(MWWorld::Ptr()));
         if (actor.getClass().isNpc() && actor.getClass().getNpcStats(actor).isWerewolf())
-        {
-            bestAction->prepare(actor);
             return bestAction;
-        }
 
         if (actor.getClass().hasInventoryStore(actor))
         {
@@ -827,6 +824,13 @@ namespace MWMechanics
         if (makeFleeDecision(actor, enemy, antiFleeRating))
             bestAction.reset(new ActionFlee());
 
+        return bestAction;
+    }
+
+    std::shared_ptr<Action> prepareNextAction(const MWWorld::Ptr &actor, const MWWorld::Ptr &enemy)
+    {
+        std::shared_ptr<Action> bestAction = selectNextAction(actor, enemy);
+
         if (bestAction.get())
             bestAction->prepare(actor);
 
@@ -100,6 +100,12 @@ namespace MWMechanics
     /// @note target may be empty
     float rateEffects (const ESM::EffectList& list, const MWWorld::Ptr& actor, const MWWorld::Ptr& enemy);
 
+    /// Rate the actor's items and spells against \a enemy and return the best action, without preparing it.
+    /// @note Only reads the state of the actor and enemy, so may be called for several actors in parallel, as long as
+    /// the encumbrance of both was queried beforehand (the container weight is computed lazily).
+    std::shared_ptr<Action> selectNextAction (const MWWorld::Ptr& actor, const MWWorld::Ptr& enemy);
+
+    /// Select the next action and prepare it.
     std::shared_ptr<Action> prepareNextAction (const MWWorld::Ptr& actor, const MWWorld::Ptr& enemy);
 
     float getDistanceMinusHalfExtents(const MWWorld::Ptr& actor, const MWWorld::Ptr& enemy, bool minusZDist=false);
@@ -62,6 +62,15 @@ namespace MWMechanics
             /// \return Package completed?
             virtual bool execute (const MWWorld::Ptr& actor, CharacterController& characterController, AiState& state, float duration) = 0;
 
+            /// Prepares think() for the execute() of this frame, and warms any lazily computed state it reads.
+            /// Called from the main thread before any actor thinks.
+            /// \return Does the package have anything to think about?
+            virtual bool prepareThink (const MWWorld::Ptr& actor, const CharacterController& characterController, AiState& state, float duration) { return false; }
+
+            /// Runs decision making that only reads the world, storing the results in \a state for the following execute().
+            /// Called for several actors in parallel, so it must not modify anything except \a state.
+            virtual void think (const MWWorld::Ptr& actor, AiState& state) const {}
+
             /// Returns the TypeID of the AiPackage
             /// \see enum TypeId
             virtual int getTypeId() const = 0;
@@ -0,0 +1,158 @@
+#include "aischeduler.hpp"
+
+#include <algorithm>
+
+#include <osg/Stats>
+
+namespace
+{
+    // Seconds between two runs of each task
+    const float sIntervals[MWMechanics::AiScheduler::Task_Count] = { 1.0f, 0.3f, 1.0f };
+
+    // Cost assumed for a task type until it was measured
+    const double sInitialCost = 0.00001;
+
+    /// Pseudo-random phase in [0, 1), so neighbouring actor IDs end up far apart
+    float getPhase(int actorId, int task)
+    {
+        unsigned int hash = static_cast<unsigned int>(actorId * MWMechanics::AiScheduler::Task_Count + task) * 2654435761u;
+        return static_cast<float>(hash >> 8) / static_cast<float>(1 << 24);
+    }
+}
+
+namespace MWMechanics
+{
+    bool AiScheduler::Request::operator<(const Request& other) const
+    {
+        if (mOverdue != other.mOverdue)
+            return mOverdue;
+        if (mInCombat != other.mInCombat)
+            return mInCombat;
+        return mSqrDistance < other.mSqrDistance;
+    }
+
+    AiScheduler::AiScheduler()
+        : mBudget(0.f)
+        , mTime(0.0)
+        , mFrame(0)
+        , mNumScheduled(0)
+        , mNumDeferred(0)
+    {
+        for (int i=0; i<Task_Count; ++i)
+            mCost[i] = sInitialCost;
+    }
+
+    void AiScheduler::setBudget(float budget)
+    {
+        mBudget = budget;
+    }
+
+    void AiScheduler::beginFrame(float duration)
+    {
+        mTime += duration;
+        ++mFrame;
+        mRequests.clear();
+        mNumScheduled = 0;
+        mNumDeferred = 0;
+    }
+
+    void AiScheduler::addActor(int actorId, int tasks, bool inCombat, float sqrDistanceToPlayer)
+    {
+        ActorMap::iterator found = mActors.find(actorId);
+        if (found == mActors.end())
+        {
+            ActorTasks actor;
+            for (int i=0; i<Task_Count; ++i)
+            {
+                actor.mNextDue[i] = mTime + getPhase(actorId, i) * sIntervals[i];
+                actor.mLastRun[i] = actor.mNextDue[i] - sIntervals[i];
+                actor.mElapsed[i] = sIntervals[i];
+            }
+            found = mActors.insert(std::make_pair(actorId, actor)).first;
+        }
+
+        ActorTasks& actor = found->second;
+        actor.mScheduled = 0;
+        actor.mFrame = mFrame;
+
+        for (int i=0; i<Task_Count; ++i)
+        {
+            if (!(tasks & (1 << i)) || actor.mNextDue[i] > mTime)
+                continue;
+
+            Request request;
+            request.mActorId = actorId;
+            request.mTask = static_cast<Task>(i);
+            request.mOverdue = mTime - actor.mNextDue[i] >= sIntervals[i];
+            request.mInCombat = inCombat;
+            request.mSqrDistance = sqrDistanceToPlayer;
+            mRequests.push_back(request);
+        }
+    }
+
+    void AiScheduler::schedule()
+    {
+        ActorMap::iterator it = mActors.begin();
+        while (it != mActors.end())
+        {
+            if (it->second.mFrame != mFrame)
+                it = mActors.erase(it);
+            else
+                ++it;
+        }
+
+        std::sort(mRequests.begin(), mRequests.end());
+
+        double estimate = 0.0;
+        for (std::vector<Request>::const_iterator request = mRequests.begin(); request != mRequests.end(); ++request)
+        {
+            const double cost = mCost[request->mTask];
+
+            // The first task always runs, so a single expensive task can not stall everything
+            if (mBudget > 0.f && !request->mOverdue && estimate > 0.0 && estimate + cost > mBudget)
+            {
+                ++mNumDeferred;
+                continue;
+            }
+
+            estimate += cost;
+            ++mNumScheduled;
+
+            ActorTasks& actor = mActors[request->mActorId];
+            const int task = request->mTask;
+            actor.mScheduled |= 1 << task;
+
+            // Keep the phase of the actor, even if the task was deferred
+            while (actor.mNextDue[task] <= mTime)
+                actor.mNextDue[task] += sIntervals[task];
+
+            actor.mElapsed[task] = static_cast<float>(mTime - actor.mLastRun[task]);
+            actor.mLastRun[task] = mTime;
+        }
+    }
+
+    bool AiScheduler::isScheduled(int actorId, Task task) const
+    {
+        ActorMap::const_iterator found = mActors.find(actorId);
+        return found != mActors.end() && (found->second.mScheduled & (1 << task));
+    }
+
+    float AiScheduler::getElapsed(int actorId, Task task) const
+    {
+        ActorMap::const_iterator found = mActors.find(actorId);
+        if (found == mActors.end())
+            return sIntervals[task];
+        return found->second.mElapsed[task];
+    }
+
+    void AiScheduler::addCost(Task task, double seconds)
+    {
+        mCost[task] = mCost[task] * 0.9 + seconds * 0.1;
+    }
+
+    void AiScheduler::reportStats(unsigned int frameNumber, osg::Stats* stats) const
+    {
+        stats->setAttribute(frameNumber, "AI Scheduled", mNumScheduled);
+        stats->setAttribute(frameNumber, "AI Deferred", mNumDeferred);
+    }
+}
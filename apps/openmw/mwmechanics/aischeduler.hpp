@@ -0,0 +1,93 @@
+#ifndef OPENMW_MECHANICS_AISCHEDULER_H
+#define OPENMW_MECHANICS_AISCHEDULER_H
+
+#include <unordered_map>
+#include <vector>
+
+namespace osg
+{
+    class Stats;
+}
+
+namespace MWMechanics
+{
+    /// @brief Spreads the periodic AI tasks of actors over frames and limits how much of that work runs per frame.
+    ///
+    /// Each actor runs a task once per interval, at a phase offset derived from its actor ID, so the work of
+    /// many actors does not pile up on the same frame. Tasks that are due are ordered by priority (actors in combat
+    /// first, then by distance to the player) and admitted until the estimated cost reaches the frame budget.
+    /// Tasks over the budget are deferred to the next frame. Once a task is late by a whole interval it runs regardless of the budget.
+    class AiScheduler
+    {
+    public:
+        enum Task
+        {
+            Task_UpdateTargets,
+            Task_HeadTracking,
+            Task_EquippedLight,
+
+            Task_Count
+        };
+
+        AiScheduler();
+
+        /// @param budget Seconds per frame that periodic tasks may take, 0 for no limit
+        void setBudget(float budget);
+
+        /// Advance the scheduler clock and start collecting the tasks of a new frame.
+        void beginFrame(float duration);
+
+        /// Request the tasks in the \a tasks bitmask (1 << Task) that are due for an actor.
+        /// @param inCombat Give the actor precedence over actors that are not in combat
+        void addActor(int actorId, int tasks, bool inCombat, float sqrDistanceToPlayer);
+
+        /// Decide which of the requested tasks run this frame. Forgets actors that were not added since beginFrame.
+        void schedule();
+
+        bool isScheduled(int actorId, Task task) const;
+
+        /// Time since the task last ran for this actor, for a task that is scheduled this frame.
+        float getElapsed(int actorId, Task task) const;
+
+        /// Feed back the time a scheduled task took, to refine the cost estimate used against the budget.
+        void addCost(Task task, double seconds);
+
+        void reportStats(unsigned int frameNumber, osg::Stats* stats) const;
+
+    private:
+        struct ActorTasks
+        {
+            double mNextDue[Task_Count];
+            double mLastRun[Task_Count];
+            float mElapsed[Task_Count]; // time between the last two runs
+            int mScheduled;
+            unsigned int mFrame;
+        };
+
+        struct Request
+        {
+            int mActorId;
+            Task mTask;
+            bool mOverdue;
+            bool mInCombat;
+            float mSqrDistance;
+
+            bool operator<(const Request& other) const;
+        };
+
+        typedef std::unordered_map<int, ActorTasks> ActorMap;
+        ActorMap mActors;
+
+        std::vector<Request> mRequests;
+
+        float mBudget;
+        double mTime;
+        unsigned int mFrame;
+        double mCost[Task_Count]; // running average in seconds
+
+        unsigned int mNumScheduled;
+        unsigned int mNumDeferred;
+    };
+}
+
+#endif
@@ -282,6 +282,21 @@ void AiSequence::execute (const MWWorld::Ptr& actor, CharacterController& charac
     }
 }
 
+bool AiSequence::prepareThink (const MWWorld::Ptr& actor, const CharacterController& characterController, AiState& state, float duration)
+{
+    if (actor == getPlayer() || mPackages.empty())
+        return false;
+
+    // execute() may still switch between combat targets, in which case the package's conclusions are simply not used
+    return mPackages.front()->prepareThink(actor, characterController, state, duration);
+}
+
+void AiSequence::think (const MWWorld::Ptr& actor, AiState& state) const
+{
+    if (!mPackages.empty())
+        mPackages.front()->think(actor, state);
+}
+
 void AiSequence::clear()
 {
     for (std::list<AiPackage *>::const_iterator iter (mPackages.begin()); iter!=mPackages.end(); ++iter)
@@ -106,6 +106,15 @@ namespace MWMechanics
             /// Execute current package, switching if needed.
             void execute (const MWWorld::Ptr& actor, CharacterController& characterController, MWMechanics::AiState& state, float duration);
 
+            /// Prepare the current package for thinking ahead of execute().
+            /// \return Should think() be called for this actor?
+            /// \see AiPackage::prepareThink
+            bool prepareThink (const MWWorld::Ptr& actor, const CharacterController& characterController, MWMechanics::AiState& state, float duration);
+
+            /// Let the current package think. May be called for several actors in parallel.
+            /// \see AiPackage::think
+            void think (const MWWorld::Ptr& actor, MWMechanics::AiState& state) const;
+
             /// Simulate the passing of time using the currently active AI package
             void fastForward(const MWWorld::Ptr &actor, AiState &state);
 
@@ -283,6 +283,12 @@ namespace MWMechanics
             mObjects.updateObject(old, ptr);
     }
 
+    void MechanicsManager::updatePosition(const MWWorld::Ptr& ptr)
+    {
+        if(ptr.getClass().isActor())
+            mActors.updatePosition(ptr);
+    }
+
 
     void MechanicsManager::drop(const MWWorld::CellStore *cellStore)
     {
@@ -304,6 +310,11 @@ namespace MWMechanics
         player.getClass().getInventoryStore(player).rechargeItems(duration);
     }
 
+    void MechanicsManager::reportStats(unsigned int frameNumber, osg::Stats* stats) const
+    {
+        mActors.reportStats(frameNumber, stats);
+    }
+
     void MechanicsManager::update(float duration, bool paused)
     {
         if(!mWatched.isEmpty())
@@ -1687,4 +1698,9 @@ namespace MWMechanics
         mActors.cleanupSummonedCreature(caster.getClass().getCreatureStats(caster), creatureActorId);
     }
 
+    PathgridNetwork& MechanicsManager::getPathgridNetwork()
+    {
+        return mPathgridNetwork;
+    }
+
 }
@@ -9,6 +9,7 @@
 #include "npcstats.hpp"
 #include "objects.hpp"
 #include "actors.hpp"
+#include "pathgridnetwork.hpp"
 
 namespace MWWorld
 {
@@ -39,6 +40,8 @@ namespace MWMechanics
             Objects mObjects;
             Actors mActors;
 
+            PathgridNetwork mPathgridNetwork;
+
             typedef std::pair<std::string, bool> Owner; // < Owner id, bool isFaction >
             typedef std::map<Owner, int> OwnerMap; // < Owner, number of stolen items with this id from this owner >
             typedef std::map<std::string, OwnerMap> StolenItemsMap;
@@ -61,6 +64,9 @@ namespace MWMechanics
             virtual void updateCell(const MWWorld::Ptr &old, const MWWorld::Ptr &ptr);
             ///< Moves an object to a new cell
 
+            virtual void updatePosition(const MWWorld::Ptr& ptr);
+            ///< Has to be called after an object has been moved, so that proximity queries see its new position
+
             virtual void drop(const MWWorld::CellStore *cellStore);
             ///< Deregister all objects in the given cell.
 
@@ -76,6 +82,8 @@ namespace MWMechanics
 
             virtual void advanceTime (float duration);
 
+            virtual void reportStats (unsigned int frameNumber, osg::Stats* stats) const;
+
             virtual void setPlayerName (const std::string& name);
             ///< Set player name.
 
@@ -216,6 +224,8 @@ namespace MWMechanics
 
             virtual void cleanupSummonedCreature(const MWWorld::Ptr& caster, int creatureActorId);
 
+            virtual PathgridNetwork& getPathgridNetwork();
+
         private:
             void reportCrime (const MWWorld::Ptr& ptr, const MWWorld::Ptr& victim,
                                       OffenseType type, int arg=0);
@@ -2,13 +2,17 @@
 
 #include <limits>
 
+#include <components/esm/loadland.hpp>
+
 #include "../mwbase/world.hpp"
 #include "../mwbase/environment.hpp"
+#include "../mwbase/mechanicsmanager.hpp"
 
 #include "../mwworld/esmstore.hpp"
 #include "../mwworld/cellstore.hpp"
 
 #include "coordinateconverter.hpp"
+#include "pathgridnetwork.hpp"
 
 namespace
 {
@@ -55,6 +59,22 @@ namespace
             (closestReachableIndex, closestReachableIndex == closestIndex);
     }
 
+    // pos is expected to be in the local coordinates of an exterior cell
+    bool isInCell(const osg::Vec3f& pos)
+    {
+        const float size = static_cast<float>(ESM::Land::REAL_SIZE);
+        return pos.x() >= 0.f && pos.x() < size && pos.y() >= 0.f && pos.y() < size;
+    }
+
+    // Route over the pathgrids of several exterior cells, path is left alone if there is none
+    bool buildNetworkPath(const ESM::Pathgrid::Point& startPoint, const ESM::Pathgrid::Point& endPoint,
+                          std::list<ESM::Pathgrid::Point>& path)
+    {
+        if (!MWBase::Environment::get().getMechanicsManager()->getPathgridNetwork().findPath(startPoint, endPoint, path))
+            return false;
+        path.push_back(endPoint);
+        return true;
+    }
 }
 
 namespace MWMechanics
@@ -215,11 +235,17 @@ namespace MWMechanics
             return;
         }
 
+        // Destinations in another exterior cell are routed over the pathgrids of the cells in between,
+        // falling back to the current cell's pathgrid if that fails. The network is also tried when
+        // the current cell's pathgrid has no route of its own.
+        const bool exterior = mCell->getCell()->isExterior();
+        if (exterior && !isInCell(endPointInLocalCoords) && buildNetworkPath(startPoint, endPoint, mPath))
+            return;
+
         // AiWander has logic that depends on whether a path was created,
         // deleting allowed nodes if not.  Hence a path needs to be created
-        // even if the start and the end points are the same.
-        // NOTE: aStarSearch will return an empty path if the start and end
-        //       nodes are the same
+        // even if the start and the end points are the same, which is
+        // handled here without going through aStarSearch.
         if(startNode == endNode.first)
         {
             ESM::Pathgrid::Point temp(mPathgrid->mPoints[startNode]);
@@ -228,12 +254,16 @@ namespace MWMechanics
         }
         else
         {
-            mPath = mCell->aStarSearch(startNode, endNode.first);
+            if (!mCell->aStarSearch(startNode, endNode.first, mPathgridPath)
+                    && exterior && buildNetworkPath(startPoint, endPoint, mPath))
+                return;
 
             // convert supplied path to world coordinates
-            for (std::list<ESM::Pathgrid::Point>::iterator iter(mPath.begin()); iter != mPath.end(); ++iter)
+            for (std::vector<int>::const_iterator iter(mPathgridPath.begin()); iter != mPathgridPath.end(); ++iter)
             {
-                converter.toWorld(*iter);
+                ESM::Pathgrid::Point point(mPathgrid->mPoints[*iter]);
+                converter.toWorld(point);
+                mPath.push_back(point);
             }
         }
 
@@ -2,6 +2,7 @@
 #define GAME_MWMECHANICS_PATHFINDING_H
 
 #include <list>
+#include <vector>
 #include <cassert>
 
 #include <components/esm/defs.hpp>
@@ -153,6 +154,9 @@ namespace MWMechanics
         private:
             std::list<ESM::Pathgrid::Point> mPath;
 
+            // pathgrid point indexes returned by the last search, kept to reuse its storage
+            std::vector<int> mPathgridPath;
+
             const ESM::Pathgrid *mPathgrid;
             const MWWorld::CellStore* mCell;
     };
@@ -1,5 +1,8 @@
 #include "pathgrid.hpp"
 
+#include <algorithm>
+#include <functional>
+
 #include "../mwbase/world.hpp"
 #include "../mwbase/environment.hpp"
 
@@ -57,6 +60,8 @@ namespace MWMechanics
         , mIsGraphConstructed(false)
         , mSCCId(0)
         , mSCCIndex(0)
+        , mSearchGeneration(0)
+        , mNextCachedPath(0)
     {
     }
 
@@ -97,6 +102,14 @@ namespace MWMechanics
      *      high cost
      */
     bool PathgridGraph::load(const MWWorld::CellStore *cell)
+    {
+        if(!cell)
+            return false;
+
+        return load(cell->getCell());
+    }
+
+    bool PathgridGraph::load(const ESM::Cell *cell)
     {
         if(!cell)
             return false;
@@ -104,9 +117,9 @@ namespace MWMechanics
         if(mIsGraphConstructed)
             return true;
 
-        mCell = cell->getCell();
-        mIsExterior = cell->getCell()->isExterior();
-        mPathgrid = MWBase::Environment::get().getWorld()->getStore().get<ESM::Pathgrid>().search(*cell->getCell());
+        mCell = cell;
+        mIsExterior = cell->isExterior();
+        mPathgrid = MWBase::Environment::get().getWorld()->getStore().get<ESM::Pathgrid>().search(*cell);
         if(!mPathgrid)
             return false;
 
@@ -214,6 +227,36 @@ namespace MWMechanics
         return (mGraph[start].componentId == mGraph[end].componentId);
     }
 
+    bool PathgridGraph::aStarSearch(const int start, const int goal, std::vector<int>& path) const
+    {
+        path.clear();
+        if(!isPointConnected(start, goal))
+        {
+            return false; // there is no path, return an empty path
+        }
+
+        for(std::vector<CachedPath>::const_iterator it = mPathCache.begin(); it != mPathCache.end(); ++it)
+        {
+            if(it->start == start && it->end == goal)
+            {
+                path = it->path;
+                return !path.empty();
+            }
+        }
+
+        search(start, goal, path);
+
+        if(mPathCache.size() < sPathCacheSize)
+            mPathCache.push_back(CachedPath());
+        CachedPath& cached = mPathCache[mNextCachedPath];
+        mNextCachedPath = (mNextCachedPath + 1) % sPathCacheSize;
+        cached.start = start;
+        cached.end = goal;
+        cached.path = path;
+
+        return !path.empty();
+    }
+
     /*
      * NOTE: Based on buildPath2(), please check git history if interested
      *       Should consider using a 3rd party library version (e.g. boost)
@@ -222,106 +265,99 @@ namespace MWMechanics
      * Uses mGraph which has pre-computed costs for allowed edges.  It is assumed
      * that mGraph is already constructed.
      *
-     * Should be possible to make this MT safe.
-     *
-     * Returns path which may be empty.  path contains pathgrid points in local
-     * cell coordinates (indoors) or world coordinates (external).
+     * Returns path which may be empty.  path contains pathgrid point indexes.
      *
      * Input params:
      *   start, goal - pathgrid point indexes (for this cell)
      *
      * Variables:
-     *   openset - point indexes to be traversed, lowest cost at the front
-     *   closedset - point indexes already traversed
-     *   gScore - past accumulated costs vector indexed by point index
-     *   fScore - future estimated costs vector indexed by point index
-     *
-     * TODO: An intersting exercise might be to cache the paths created for a
-     *       start/goal pair.  To cache the results the paths need to be in
-     *       pathgrid points form (currently they are converted to world
-     *       coordinates).  Essentially trading speed w/ memory.
+     *   mOpenSet - binary heap of point indexes to be traversed, lowest fScore
+     *              at the front. A point may be pushed again when a cheaper
+     *              route to it is found, outdated entries are skipped when
+     *              popped.
+     *   mSearchPoints - past accumulated costs, parents and open/closed state
+     *                   indexed by point index. Instead of being cleared for
+     *                   every search, entries from older searches are told
+     *                   apart by their stamps.
      */
-    std::list<ESM::Pathgrid::Point> PathgridGraph::aStarSearch(const int start,
-                                                               const int goal) const
+    void PathgridGraph::search(const int start, const int goal, std::vector<int>& path) const
     {
-        std::list<ESM::Pathgrid::Point> path;
-        if(!isPointConnected(start, goal))
+        if(mSearchPoints.size() != mGraph.size())
         {
-            return path; // there is no path, return an empty path
+            SearchPoint initial;
+            initial.openedStamp = 0;
+            initial.closedStamp = 0;
+            initial.gScore = 0;
+            initial.parent = -1;
+            mSearchPoints.assign(mGraph.size(), initial);
+            mSearchGeneration = 0;
         }
 
-        int graphSize = static_cast<int> (mGraph.size());
-        std::vector<float> gScore (graphSize, -1);
-        std::vector<float> fScore (graphSize, -1);
-        std::vector<int> graphParent (graphSize, -1);
-
-        // gScore & fScore keep costs for each pathgrid point in mPoints
-        gScore[start] = 0;
-        fScore[start] = costAStar(mPathgrid->mPoints[start], mPathgrid->mPoints[goal]);
+        if(++mSearchGeneration == 0)
+        {
+            // stamps wrapped around, forget everything
+            for(std::vector<SearchPoint>::iterator it = mSearchPoints.begin(); it != mSearchPoints.end(); ++it)
+                it->openedStamp = it->closedStamp = 0;
+            mSearchGeneration = 1;
+        }
+        const unsigned int generation = mSearchGeneration;
 
-        std::list<int> openset;
-        std::list<int> closedset;
-        openset.push_back(start);
+        std::greater<OpenPoint> compare; // std heaps keep the largest element at the front
+        mOpenSet.clear();
 
-        int current = -1;
+        SearchPoint& first = mSearchPoints[start];
+        first.openedStamp = generation;
+        first.gScore = 0;
+        first.parent = -1;
+        mOpenSet.push_back(OpenPoint(costAStar(mPathgrid->mPoints[start], mPathgrid->mPoints[goal]), start));
 
-        while(!openset.empty())
+        bool found = false;
+        while(!mOpenSet.empty())
         {
-            current = openset.front(); // front has the lowest cost
-            openset.pop_front();
+            std::pop_heap(mOpenSet.begin(), mOpenSet.end(), compare);
+            const int current = mOpenSet.back().second;
+            mOpenSet.pop_back();
+
+            SearchPoint& currentPoint = mSearchPoints[current];
+            if(currentPoint.closedStamp == generation)
+                continue; // outdated entry, the point was already reached more cheaply
 
             if(current == goal)
+            {
+                found = true;
                 break;
+            }
 
-            closedset.push_back(current); // remember we've been here
+            currentPoint.closedStamp = generation; // remember we've been here
 
             // check all edges for the current point index
-            for(int j = 0; j < static_cast<int> (mGraph[current].edges.size()); j++)
+            const std::vector<ConnectedPoint>& edges = mGraph[current].edges;
+            for(std::vector<ConnectedPoint>::const_iterator edge = edges.begin(); edge != edges.end(); ++edge)
             {
-                if(std::find(closedset.begin(), closedset.end(), mGraph[current].edges[j].index) ==
-                   closedset.end())
+                const int dest = edge->index;
+                SearchPoint& destPoint = mSearchPoints[dest];
+                if(destPoint.closedStamp == generation)
+                    continue; // traversed this edge destination already
+
+                const float tentative_g = currentPoint.gScore + edge->cost;
+                if(destPoint.openedStamp != generation || tentative_g < destPoint.gScore)
                 {
-                    // not in closedset - i.e. have not traversed this edge destination
-                    int dest = mGraph[current].edges[j].index;
-                    float tentative_g = gScore[current] + mGraph[current].edges[j].cost;
-                    bool isInOpenSet = std::find(openset.begin(), openset.end(), dest) != openset.end();
-                    if(!isInOpenSet
-                        || tentative_g < gScore[dest])
-                    {
-                        graphParent[dest] = current;
-                        gScore[dest] = tentative_g;
-                        fScore[dest] = tentative_g + costAStar(mPathgrid->mPoints[dest],
-                                                               mPathgrid->mPoints[goal]);
-                        if(!isInOpenSet)
-                        {
-                            // add this edge to openset, lowest cost goes to the front
-                            // TODO: if this causes performance problems a hash table may help
-                            std::list<int>::iterator it = openset.begin();
-                            for(it = openset.begin(); it!= openset.end(); ++it)
-                            {
-                                if(fScore[*it] > fScore[dest])
-                                    break;
-                            }
-                            openset.insert(it, dest);
-                        }
-                    }
-                } // if in closedset, i.e. traversed this edge already, try the next edge
+                    destPoint.openedStamp = generation;
+                    destPoint.parent = current;
+                    destPoint.gScore = tentative_g;
+                    const float fScore = tentative_g + costAStar(mPathgrid->mPoints[dest], mPathgrid->mPoints[goal]);
+                    mOpenSet.push_back(OpenPoint(fScore, dest));
+                    std::push_heap(mOpenSet.begin(), mOpenSet.end(), compare);
+                }
             }
         }
 
-        if(current != goal)
-            return path; // for some reason couldn't build a path
+        if(!found)
+            return; // for some reason couldn't build a path
 
-        // reconstruct path to return, using local coordinates
-        while(graphParent[current] != -1)
-        {
-            path.push_front(mPathgrid->mPoints[current]);
-            current = graphParent[current];
-        }
-
-        // add first node to path explicitly
-        path.push_front(mPathgrid->mPoints[start]);
-        return path;
+        // reconstruct path to return, from the goal back to the start
+        for(int current = goal; current != -1; current = mSearchPoints[current].parent)
+            path.push_back(current);
+        std::reverse(path.begin(), path.end());
     }
 }
-
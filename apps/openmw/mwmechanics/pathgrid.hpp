@@ -1,7 +1,7 @@
 #ifndef GAME_MWMECHANICS_PATHGRID_H
 #define GAME_MWMECHANICS_PATHGRID_H
 
-#include <list>
+#include <vector>
 
 #include <components/esm/loadpgrd.hpp>
 
@@ -24,17 +24,21 @@ namespace MWMechanics
 
             bool load(const MWWorld::CellStore *cell);
 
+            // same as above, for cells that are not loaded into a CellStore
+            bool load(const ESM::Cell *cell);
+
             // returns true if end point is strongly connected (i.e. reachable
             // from start point) both start and end are pathgrid point indexes
             bool isPointConnected(const int start, const int end) const;
 
             // the input parameters are pathgrid point indexes
-            // the output list is in local (internal cells) or world (external
-            // cells) coordinates
+            // the output vector is filled with the pathgrid point indexes
+            // from start to end, both included, and left empty if there is
+            // no path
             //
-            // NOTE: if start equals end an empty path is returned
-            std::list<ESM::Pathgrid::Point> aStarSearch(const int start,
-                                                        const int end) const;
+            // NOTE: not thread safe, uses scratch buffers and a cache of
+            // recent results owned by the graph
+            bool aStarSearch(const int start, const int end, std::vector<int>& path) const;
         private:
 
             const ESM::Cell *mCell;
@@ -74,6 +78,33 @@ namespace MWMechanics
             // methods used to calculate connected components
             void recursiveStrongConnect(int v);
             void buildConnectedPoints();
+
+            // scratch buffers for aStarSearch, valid for a point if its
+            // stamp equals the current search generation
+            struct SearchPoint
+            {
+                unsigned int openedStamp;
+                unsigned int closedStamp;
+                float gScore;
+                int parent;
+            };
+            typedef std::pair<float, int> OpenPoint; // first is fScore, second is index
+            mutable std::vector<SearchPoint> mSearchPoints;
+            mutable std::vector<OpenPoint> mOpenSet; // binary heap, lowest fScore at the front
+            mutable unsigned int mSearchGeneration;
+
+            // AiWander and AiTravel tend to request the same paths repeatedly
+            struct CachedPath
+            {
+                int start;
+                int end;
+                std::vector<int> path;
+            };
+            static const size_t sPathCacheSize = 8;
+            mutable std::vector<CachedPath> mPathCache;
+            mutable size_t mNextCachedPath;
+
+            void search(const int start, const int end, std::vector<int>& path) const;
     };
 }
 
@@ -0,0 +1,406 @@
+#include "pathgridnetwork.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+
+#include <components/esm/loadcell.hpp>
+#include <components/esm/loadland.hpp>
+
+#include "../mwbase/world.hpp"
+#include "../mwbase/environment.hpp"
+
+#include "../mwworld/esmstore.hpp"
+
+#include "pathfinding.hpp"
+
+namespace
+{
+    const int sCellSize = ESM::Land::REAL_SIZE;
+
+    // Pathgrid points closer than this to a cell border are linked to the nearest point of the neighbouring
+    // cell, if that one is within the same distance. Vanilla pathgrids rarely leave bigger gaps at borders.
+    const float sMaxLinkDistance = 1024.f;
+
+    // How many cells around the start and end cells a search may wander into
+    const int sSearchMargin = 2;
+
+    // Give up on searches that expand more nodes than this, the actor will walk straight at its target instead
+    const int sMaxExpandedNodes = 2048;
+
+    const size_t sRouteCacheSize = 16;
+
+    // Once more cells than this are loaded, those a new search can't reach are dropped again
+    const size_t sMaxCachedCells = 64;
+
+    int getCellCoordinate(float value)
+    {
+        return static_cast<int>(std::floor(value / sCellSize));
+    }
+
+    ESM::Pathgrid::Point toWorld(const std::pair<int, int>& cell, const ESM::Pathgrid::Point& point)
+    {
+        ESM::Pathgrid::Point result(point);
+        result.mX += cell.first * sCellSize;
+        result.mY += cell.second * sCellSize;
+        return result;
+    }
+}
+
+namespace MWMechanics
+{
+    PathgridNetwork::CellData::CellData()
+        : mPathgrid(NULL)
+        , mLinksBuilt(false)
+    {
+    }
+
+    PathgridNetwork::Node::Node()
+        : mPoint(-1)
+    {
+    }
+
+    PathgridNetwork::Node::Node(const CellIndex& cell, int point)
+        : mCell(cell)
+        , mPoint(point)
+    {
+    }
+
+    PathgridNetwork::PathgridNetwork()
+        : mNextCachedRoute(0)
+    {
+    }
+
+    bool PathgridNetwork::findPath(const ESM::Pathgrid::Point& start, const ESM::Pathgrid::Point& end,
+                                   std::list<ESM::Pathgrid::Point>& path)
+    {
+        const CellIndex startCell(getCellCoordinate(start.mX), getCellCoordinate(start.mY));
+        const CellIndex endCell(getCellCoordinate(end.mX), getCellCoordinate(end.mY));
+        if (startCell == endCell)
+            return false;
+
+        if (mCells.size() > sMaxCachedCells)
+            evictCells(startCell, endCell);
+
+        CellData& startData = getCell(startCell);
+        CellData& endData = getCell(endCell);
+        if (!startData.mPathgrid || !endData.mPathgrid)
+            return false;
+
+        const Node startNode(startCell, getClosestPoint(startCell, startData, start));
+        const Node endNode(endCell, getClosestPoint(endCell, endData, end));
+
+        const CachedRoute* cached = NULL;
+        for (std::vector<CachedRoute>::const_iterator it = mRouteCache.begin(); it != mRouteCache.end(); ++it)
+        {
+            if (it->mStart == startNode && it->mEnd == endNode)
+            {
+                cached = &*it;
+                break;
+            }
+        }
+
+        if (!cached)
+        {
+            if (mRouteCache.size() < sRouteCacheSize)
+                mRouteCache.push_back(CachedRoute());
+            CachedRoute& route = mRouteCache[mNextCachedRoute];
+            mNextCachedRoute = (mNextCachedRoute + 1) % sRouteCacheSize;
+
+            route.mStart = startNode;
+            route.mEnd = endNode;
+            route.mPath.clear();
+
+            // Failed searches are the expensive ones, so they are cached as an empty route too
+            std::vector<Node> nodes;
+            if (search(startNode, endNode, nodes))
+                refine(nodes, route.mPath);
+
+            cached = &route;
+        }
+
+        if (cached->mPath.empty())
+            return false;
+
+        path.insert(path.end(), cached->mPath.begin(), cached->mPath.end());
+        return true;
+    }
+
+    void PathgridNetwork::evictCells(const CellIndex& start, const CellIndex& end)
+    {
+        // buildLinks looks one cell past the area a search may wander into
+        const int margin = sSearchMargin + 1;
+        const int minX = std::min(start.first, end.first) - margin;
+        const int maxX = std::max(start.first, end.first) + margin;
+        const int minY = std::min(start.second, end.second) - margin;
+        const int maxY = std::max(start.second, end.second) + margin;
+
+        for (CellMap::iterator it = mCells.begin(); it != mCells.end();)
+        {
+            if (it->first.first < minX || it->first.first > maxX
+                    || it->first.second < minY || it->first.second > maxY)
+                mCells.erase(it++);
+            else
+                ++it;
+        }
+    }
+
+    PathgridNetwork::CellData& PathgridNetwork::getCell(const CellIndex& index)
+    {
+        CellMap::iterator found = mCells.find(index);
+        if (found != mCells.end())
+            return found->second;
+
+        CellData& cell = mCells[index];
+
+        const MWWorld::ESMStore& store = MWBase::Environment::get().getWorld()->getStore();
+        const ESM::Cell* esmCell = store.get<ESM::Cell>().search(index.first, index.second);
+        if (esmCell && cell.mGraph.load(esmCell))
+        {
+            const ESM::Pathgrid* pathgrid = store.get<ESM::Pathgrid>().search(*esmCell);
+            if (pathgrid && !pathgrid->mPoints.empty())
+                cell.mPathgrid = pathgrid;
+        }
+
+        return cell;
+    }
+
+    void PathgridNetwork::buildLinks(const CellIndex& index, CellData& cell)
+    {
+        cell.mLinksBuilt = true;
+        if (!cell.mPathgrid)
+            return;
+
+        static const int sDirections[4][2] = { {-1, 0}, {1, 0}, {0, -1}, {0, 1} };
+
+        const ESM::Pathgrid::PointList& points = cell.mPathgrid->mPoints;
+        for (int i = 0; i < static_cast<int>(points.size()); ++i)
+        {
+            const ESM::Pathgrid::Point& point = points[i];
+            for (int d = 0; d < 4; ++d)
+            {
+                const int dx = sDirections[d][0];
+                const int dy = sDirections[d][1];
+
+                float distanceToBorder;
+                if (dx < 0)
+                    distanceToBorder = static_cast<float>(point.mX);
+                else if (dx > 0)
+                    distanceToBorder = static_cast<float>(sCellSize - point.mX);
+                else if (dy < 0)
+                    distanceToBorder = static_cast<float>(point.mY);
+                else
+                    distanceToBorder = static_cast<float>(sCellSize - point.mY);
+
+                if (distanceToBorder > sMaxLinkDistance)
+                    continue;
+
+                const CellIndex targetIndex(index.first + dx, index.second + dy);
+                const CellData& target = getCell(targetIndex);
+                if (!target.mPathgrid)
+                    continue;
+
+                const ESM::Pathgrid::Point worldPoint = toWorld(index, point);
+                const int targetPoint = getClosestPoint(targetIndex, target, worldPoint);
+                const float cost = distance(worldPoint, toWorld(targetIndex, target.mPathgrid->mPoints[targetPoint]));
+                if (cost > sMaxLinkDistance)
+                    continue;
+
+                Link link;
+                link.mPoint = i;
+                link.mTargetCell = targetIndex;
+                link.mTargetPoint = targetPoint;
+                link.mCost = cost;
+                cell.mLinks.push_back(link);
+
+                if (cell.mPortals.empty() || cell.mPortals.back() != i)
+                    cell.mPortals.push_back(i);
+            }
+        }
+    }
+
+    int PathgridNetwork::getClosestPoint(const CellIndex& index, const CellData& cell, const ESM::Pathgrid::Point& point) const
+    {
+        const ESM::Pathgrid::PointList& points = cell.mPathgrid->mPoints;
+
+        int closest = 0;
+        float closestDistance = std::numeric_limits<float>::max();
+        for (int i = 0; i < static_cast<int>(points.size()); ++i)
+        {
+            const float current = distance(toWorld(index, points[i]), point);
+            if (current < closestDistance)
+            {
+                closest = i;
+                closestDistance = current;
+            }
+        }
+        return closest;
+    }
+
+    const std::vector<PathgridNetwork::PortalCost>& PathgridNetwork::getPortalCosts(CellData& cell, int start)
+    {
+        std::map<int, std::vector<PortalCost> >::const_iterator found = cell.mPortalCosts.find(start);
+        if (found != cell.mPortalCosts.end())
+            return found->second;
+
+        std::vector<PortalCost>& costs = cell.mPortalCosts[start];
+        for (std::vector<int>::const_iterator it = cell.mPortals.begin(); it != cell.mPortals.end(); ++it)
+        {
+            if (*it == start)
+                continue;
+
+            const float cost = getRouteCost(cell, start, *it);
+            if (cost >= 0.f)
+                costs.push_back(PortalCost(*it, cost));
+        }
+        return costs;
+    }
+
+    float PathgridNetwork::getRouteCost(CellData& cell, int start, int end)
+    {
+        if (start == end)
+            return 0.f;
+
+        if (!cell.mGraph.aStarSearch(start, end, mSearchPath))
+            return -1.f;
+
+        // Both points are in the same cell, so local coordinates give the same lengths as world ones
+        const ESM::Pathgrid::PointList& points = cell.mPathgrid->mPoints;
+        float cost = 0.f;
+        for (size_t i = 1; i < mSearchPath.size(); ++i)
+            cost += distance(points[mSearchPath[i - 1]], points[mSearchPath[i]]);
+        return cost;
+    }
+
+    ESM::Pathgrid::Point PathgridNetwork::getWorldPoint(const Node& node)
+    {
+        return toWorld(node.mCell, getCell(node.mCell).mPathgrid->mPoints[node.mPoint]);
+    }
+
+    bool PathgridNetwork::search(const Node& start, const Node& end, std::vector<Node>& route)
+    {
+        route.clear();
+
+        const int minX = std::min(start.mCell.first, end.mCell.first) - sSearchMargin;
+        const int maxX = std::max(start.mCell.first, end.mCell.first) + sSearchMargin;
+        const int minY = std::min(start.mCell.second, end.mCell.second) - sSearchMargin;
+        const int maxY = std::max(start.mCell.second, end.mCell.second) + sSearchMargin;
+
+        const ESM::Pathgrid::Point goal = getWorldPoint(end);
+
+        struct Record
+        {
+            float mScore;
+            Node mParent;
+            bool mClosed;
+        };
+        std::map<Node, Record> records;
+
+        // Stale entries are left in the queue and skipped once their node is closed
+        typedef std::pair<float, Node> OpenNode; // first is fScore
+        std::priority_queue<OpenNode, std::vector<OpenNode>, std::greater<OpenNode> > open;
+
+        Record& first = records[start];
+        first.mScore = 0.f;
+        first.mParent = start;
+        first.mClosed = false;
+        open.push(OpenNode(distance(getWorldPoint(start), goal), start));
+
+        int expanded = 0;
+        while (!open.empty())
+        {
+            const Node current = open.top().second;
+            open.pop();
+
+            Record& record = records[current];
+            if (record.mClosed)
+                continue;
+            record.mClosed = true;
+
+            if (current == end)
+            {
+                for (Node node = end; !(node == start); node = records[node].mParent)
+                    route.push_back(node);
+                route.push_back(start);
+                std::reverse(route.begin(), route.end());
+                return true;
+            }
+
+            if (++expanded > sMaxExpandedNodes)
+                return false;
+
+            const float score = record.mScore;
+
+            CellData& cell = getCell(current.mCell);
+            if (!cell.mLinksBuilt)
+                buildLinks(current.mCell, cell);
+
+            mNeighbours.clear();
+
+            if (current.mCell == end.mCell)
+            {
+                const float cost = getRouteCost(cell, current.mPoint, end.mPoint);
+                if (cost >= 0.f)
+                    mNeighbours.push_back(std::make_pair(end, cost));
+            }
+
+            const std::vector<PortalCost>& portals = getPortalCosts(cell, current.mPoint);
+            for (std::vector<PortalCost>::const_iterator it = portals.begin(); it != portals.end(); ++it)
+                mNeighbours.push_back(std::make_pair(Node(current.mCell, it->first), it->second));
+
+            // mLinks is sorted by mPoint
+            for (std::vector<Link>::const_iterator it = cell.mLinks.begin(); it != cell.mLinks.end(); ++it)
+            {
+                if (it->mPoint < current.mPoint)
+                    continue;
+                if (it->mPoint > current.mPoint)
+                    break;
+                if (it->mTargetCell.first < minX || it->mTargetCell.first > maxX
+                        || it->mTargetCell.second < minY || it->mTargetCell.second > maxY)
+                    continue;
+                mNeighbours.push_back(std::make_pair(Node(it->mTargetCell, it->mTargetPoint), it->mCost));
+            }
+
+            for (std::vector<std::pair<Node, float> >::const_iterator it = mNeighbours.begin(); it != mNeighbours.end(); ++it)
+            {
+                const float newScore = score + it->second;
+
+                std::map<Node, Record>::iterator found = records.find(it->first);
+                if (found != records.end() && (found->second.mClosed || found->second.mScore <= newScore))
+                    continue;
+
+                Record& neighbour = records[it->first];
+                neighbour.mScore = newScore;
+                neighbour.mParent = current;
+                neighbour.mClosed = false;
+                open.push(OpenNode(newScore + distance(getWorldPoint(it->first), goal), it->first));
+            }
+        }
+
+        return false;
+    }
+
+    void PathgridNetwork::refine(const std::vector<Node>& route, std::vector<ESM::Pathgrid::Point>& path)
+    {
+        path.push_back(getWorldPoint(route.front()));
+
+        for (size_t i = 1; i < route.size(); ++i)
+        {
+            const Node& from = route[i - 1];
+            const Node& to = route[i];
+
+            // Links between cells are walked directly
+            if (from.mCell != to.mCell)
+            {
+                path.push_back(getWorldPoint(to));
+                continue;
+            }
+
+            getCell(from.mCell).mGraph.aStarSearch(from.mPoint, to.mPoint, mSearchPath);
+            for (size_t j = 1; j < mSearchPath.size(); ++j)
+                path.push_back(getWorldPoint(Node(from.mCell, mSearchPath[j])));
+        }
+    }
+}
@@ -0,0 +1,117 @@
+#ifndef GAME_MWMECHANICS_PATHGRIDNETWORK_H
+#define GAME_MWMECHANICS_PATHGRIDNETWORK_H
+
+#include <list>
+#include <map>
+#include <vector>
+
+#include <components/esm/loadpgrd.hpp>
+
+#include "pathgrid.hpp"
+
+namespace MWMechanics
+{
+    /// \brief Connects the pathgrids of neighbouring exterior cells, to find routes spanning several cells.
+    ///
+    /// Uses hierarchical A*: the coarse graph only contains the pathgrid points near cell borders that link to a point
+    /// of the neighbouring cell ("portals"), connected by the length of the route between them inside their cell.
+    /// A coarse route is then refined into pathgrid points with PathgridGraph::aStarSearch.
+    ///
+    /// Cells are loaded from the ESM store as searches reach them, and dropped again once too many are loaded.
+    /// Pathgrids never change at runtime, so neither do the links, costs and routes derived from them.
+    class PathgridNetwork
+    {
+        public:
+            PathgridNetwork();
+
+            /// Find a route between two points in world coordinates that lie in different exterior cells.
+            /// @param path Receives the pathgrid points along the route in world coordinates, not including \a end itself
+            /// @return false if either cell has no pathgrid, or no route was found
+            bool findPath(const ESM::Pathgrid::Point& start, const ESM::Pathgrid::Point& end, std::list<ESM::Pathgrid::Point>& path);
+
+        private:
+            typedef std::pair<int, int> CellIndex;
+
+            struct Link // edge to the pathgrid of a neighbouring cell
+            {
+                int mPoint;
+                CellIndex mTargetCell;
+                int mTargetPoint;
+                float mCost;
+            };
+
+            typedef std::pair<int, float> PortalCost; // first is portal point index, second is the route length to it
+
+            struct CellData
+            {
+                CellData();
+
+                const ESM::Pathgrid* mPathgrid; // NULL if the cell has no usable pathgrid
+                PathgridGraph mGraph;
+                bool mLinksBuilt;
+                std::vector<Link> mLinks; // sorted by mPoint
+                std::vector<int> mPortals; // sorted point indexes that have at least one link
+                std::map<int, std::vector<PortalCost> > mPortalCosts; // by start point index, computed on demand
+            };
+
+            typedef std::map<CellIndex, CellData> CellMap;
+            CellMap mCells;
+
+            struct Node
+            {
+                Node();
+                Node(const CellIndex& cell, int point);
+
+                CellIndex mCell;
+                int mPoint;
+
+                bool operator<(const Node& other) const
+                {
+                    if (mCell != other.mCell)
+                        return mCell < other.mCell;
+                    return mPoint < other.mPoint;
+                }
+
+                bool operator==(const Node& other) const
+                {
+                    return mCell == other.mCell && mPoint == other.mPoint;
+                }
+            };
+
+            struct CachedRoute
+            {
+                Node mStart;
+                Node mEnd;
+                std::vector<ESM::Pathgrid::Point> mPath;
+            };
+            std::vector<CachedRoute> mRouteCache;
+            size_t mNextCachedRoute;
+
+            // scratch buffers, reused between searches
+            std::vector<int> mSearchPath;
+            std::vector<std::pair<Node, float> > mNeighbours;
+
+            CellData& getCell(const CellIndex& index);
+
+            /// Drop the loaded cells that a search between \a start and \a end can't reach
+            void evictCells(const CellIndex& start, const CellIndex& end);
+
+            void buildLinks(const CellIndex& index, CellData& cell);
+
+            /// Index of the pathgrid point closest to \a point, given in world coordinates
+            int getClosestPoint(const CellIndex& index, const CellData& cell, const ESM::Pathgrid::Point& point) const;
+
+            const std::vector<PortalCost>& getPortalCosts(CellData& cell, int start);
+
+            /// Length of the route between two points of the same cell, or a negative value if there is none
+            float getRouteCost(CellData& cell, int start, int end);
+
+            ESM::Pathgrid::Point getWorldPoint(const Node& node);
+
+            bool search(const Node& start, const Node& end, std::vector<Node>& route);
+
+            void refine(const std::vector<Node>& route, std::vector<ESM::Pathgrid::Point>& path);
+    };
+}
+
+#endif
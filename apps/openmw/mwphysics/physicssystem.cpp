@@ -1,6 +1,7 @@
 #include "physicssystem.hpp"
 
 #include <stdexcept>
+#include <iostream>
 
 #include <osg/Group>
 
@@ -24,6 +25,8 @@
 #include <components/esm/loadgmst.hpp>
 #include <components/sceneutil/positionattitudetransform.hpp>
 #include <components/sceneutil/unrefqueue.hpp>
+#include <components/sceneutil/workqueue.hpp>
+#include <components/settings/settings.hpp>
 
 #include <components/nifosg/particle.hpp> // FindRecIndexVisitor
 
@@ -84,14 +87,16 @@ namespace MWPhysics
     private:
         const btCollisionWorld *mColWorld;
         const btCollisionObject *mColObj;
+        std::vector<btBroadphaseProxy*>* mSweepCandidates;
 
         ActorTracer mTracer, mUpStepper, mDownStepper;
         bool mHaveMoved;
 
     public:
-        Stepper(const btCollisionWorld *colWorld, const btCollisionObject *colObj)
+        Stepper(const btCollisionWorld *colWorld, const btCollisionObject *colObj, std::vector<btBroadphaseProxy*>* sweepCandidates)
             : mColWorld(colWorld)
             , mColObj(colObj)
+            , mSweepCandidates(sweepCandidates)
             , mHaveMoved(true)
         {}
 
@@ -144,7 +149,7 @@ namespace MWPhysics
             if (mHaveMoved)
             {
                 mHaveMoved = false;
-                mUpStepper.doTrace(mColObj, position, position+osg::Vec3f(0.0f,0.0f,sStepSizeUp), mColWorld);
+                mUpStepper.doTrace(mColObj, position, position+osg::Vec3f(0.0f,0.0f,sStepSizeUp), mColWorld, mSweepCandidates);
                 if(mUpStepper.mFraction < std::numeric_limits<float>::epsilon())
                     return false; // didn't even move the smallest representable amount
                                   // (TODO: shouldn't this be larger? Why bother with such a small amount?)
@@ -164,7 +169,7 @@ namespace MWPhysics
              *    ==============================================
              */
             osg::Vec3f tracerPos = mUpStepper.mEndPos;
-            mTracer.doTrace(mColObj, tracerPos, tracerPos + toMove, mColWorld);
+            mTracer.doTrace(mColObj, tracerPos, tracerPos + toMove, mColWorld, mSweepCandidates);
             if(mTracer.mFraction < std::numeric_limits<float>::epsilon())
                 return false; // didn't even move the smallest representable amount
 
@@ -183,7 +188,7 @@ namespace MWPhysics
              *          +--+            +--+
              *    ==============================================
              */
-            mDownStepper.doTrace(mColObj, mTracer.mEndPos, mTracer.mEndPos-osg::Vec3f(0.0f,0.0f,sStepSizeDown), mColWorld);
+            mDownStepper.doTrace(mColObj, mTracer.mEndPos, mTracer.mEndPos-osg::Vec3f(0.0f,0.0f,sStepSizeDown), mColWorld, mSweepCandidates);
             if (!canStepDown(mDownStepper))
             {
                 // Try again with increased step length
@@ -192,11 +197,11 @@ namespace MWPhysics
 
                 osg::Vec3f direction = toMove;
                 direction.normalize();
-                mTracer.doTrace(mColObj, tracerPos, tracerPos + direction*sMinStep, mColWorld);
+                mTracer.doTrace(mColObj, tracerPos, tracerPos + direction*sMinStep, mColWorld, mSweepCandidates);
                 if (mTracer.mFraction < 0.001f)
                     return false;
 
-                mDownStepper.doTrace(mColObj, mTracer.mEndPos, mTracer.mEndPos-osg::Vec3f(0.0f,0.0f,sStepSizeDown), mColWorld);
+                mDownStepper.doTrace(mColObj, mTracer.mEndPos, mTracer.mEndPos-osg::Vec3f(0.0f,0.0f,sStepSizeDown), mColWorld, mSweepCandidates);
                 if (!canStepDown(mDownStepper))
                     return false;
             }
@@ -214,6 +219,29 @@ namespace MWPhysics
         }
     };
 
+    /// Per-frame movement state of a single actor, see PhysicsSystem::applyQueuedMovement
+    /// @note Everything MovementSolver::move needs from the Ptr and the world is copied in here on the main thread,
+    /// since the solver may run on other threads while the game state is in use.
+    struct ActorFrameData
+    {
+        MWWorld::Ptr mPtr; ///< Never dereferenced while solving, only used as a key for standing collisions
+        Actor* mActor;
+        osg::Vec3f mMovement;
+        ESM::Position mRefPosition;
+        float mWaterlevel;
+        float mSwimLevel;
+        float mSlowFall;
+        bool mFlying;
+        bool mMobile;
+        bool mDead;
+        bool mPureWaterCreature;
+        osg::Vec3f mStormDirection; ///< Zero if there is no storm
+        float mStormWalkMult;
+        osg::Vec3f mPosition;
+        float mOldHeight;
+        bool mPositionChanged;
+    };
+
     class MovementSolver
     {
     private:
@@ -274,14 +302,21 @@ namespace MWPhysics
             }
         }
 
-        static osg::Vec3f move(osg::Vec3f position, const MWWorld::Ptr &ptr, Actor* physicActor, const osg::Vec3f &movement, float time,
-                                  bool isFlying, float waterlevel, float slowFall, const btCollisionWorld* collisionWorld,
-                               std::map<MWWorld::Ptr, MWWorld::Ptr>& standingCollisionTracker)
+        /// @param sweepCandidates Scratch buffer of the calling thread if other threads solve movement at the same time, see ActorTracer::doTrace
+        static osg::Vec3f move(osg::Vec3f position, const ActorFrameData& data, float time, const btCollisionWorld* collisionWorld,
+                               std::map<MWWorld::Ptr, MWWorld::Ptr>& standingCollisionTracker,
+                               std::vector<btBroadphaseProxy*>* sweepCandidates = NULL)
         {
-            const ESM::Position& refpos = ptr.getRefData().getPosition();
+            Actor* physicActor = data.mActor;
+            const osg::Vec3f& movement = data.mMovement;
+            const bool isFlying = data.mFlying;
+            const float waterlevel = data.mWaterlevel;
+            const float slowFall = data.mSlowFall;
+
+            const ESM::Position& refpos = data.mRefPosition;
             // Early-out for totally static creatures
             // (Not sure if gravity should still apply?)
-            if (!ptr.getClass().isMobile(ptr))
+            if (!data.mMobile)
                 return position;
 
             // Reset per-frame data
@@ -303,9 +338,7 @@ namespace MWPhysics
             // While this is strictly speaking wrong, it's needed for MW compatibility.
             position.z() += halfExtents.z();
 
-            static const float fSwimHeightScale = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>()
-                    .find("fSwimHeightScale")->getFloat();
-            float swimlevel = waterlevel + halfExtents.z() - (physicActor->getRenderingHalfExtents().z() * 2 * fSwimHeightScale);
+            const float swimlevel = data.mSwimLevel;
 
             ActorTracer tracer;
             osg::Vec3f inertia = physicActor->getInertialForce();
@@ -327,22 +360,18 @@ namespace MWPhysics
             }
 
             // dead actors underwater will float to the surface, if the CharacterController tells us to do so
-            if (movement.z() > 0 && ptr.getClass().getCreatureStats(ptr).isDead() && position.z() < swimlevel)
+            if (movement.z() > 0 && data.mDead && position.z() < swimlevel)
                 velocity = osg::Vec3f(0,0,1) * 25;
 
-            ptr.getClass().getMovementSettings(ptr).mPosition[2] = 0;
-
             // Now that we have the effective movement vector, apply wind forces to it
-            if (MWBase::Environment::get().getWorld()->isInStorm())
+            if (data.mStormDirection != osg::Vec3f())
             {
-                osg::Vec3f stormDirection = MWBase::Environment::get().getWorld()->getStormDirection();
+                const osg::Vec3f& stormDirection = data.mStormDirection;
                 float angleDegrees = osg::RadiansToDegrees(std::acos(stormDirection * velocity / (stormDirection.length() * velocity.length())));
-                static const float fStromWalkMult = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>()
-                        .find("fStromWalkMult")->getFloat();
-                velocity *= 1.f-(fStromWalkMult * (angleDegrees/180.f));
+                velocity *= 1.f-(data.mStormWalkMult * (angleDegrees/180.f));
             }
 
-            Stepper stepper(collisionWorld, colobj);
+            Stepper stepper(collisionWorld, colobj, sweepCandidates);
             osg::Vec3f origVelocity = velocity;
             osg::Vec3f newPosition = position;
             /*
@@ -370,7 +399,7 @@ namespace MWPhysics
                 if((newPosition - nextpos).length2() > 0.0001)
                 {
                     // trace to where character would go if there were no obstructions
-                    tracer.doTrace(colobj, newPosition, nextpos, collisionWorld);
+                    tracer.doTrace(colobj, newPosition, nextpos, collisionWorld, sweepCandidates);
 
                     // check for obstructions
                     if(tracer.mFraction >= 1.0f)
@@ -412,7 +441,7 @@ namespace MWPhysics
                 if (result)
                 {
                     // don't let pure water creatures move out of water after stepMove
-                    if (ptr.getClass().isPureWaterCreature(ptr)
+                    if (data.mPureWaterCreature
                             && newPosition.z() + halfExtents.z() > waterlevel)
                         newPosition = oldPosition;
                 }
@@ -442,14 +471,14 @@ namespace MWPhysics
                 osg::Vec3f from = newPosition;
                 osg::Vec3f to = newPosition - (physicActor->getOnGround() ?
                              osg::Vec3f(0,0,sStepSizeDown + 2*sGroundOffset) : osg::Vec3f(0,0,2*sGroundOffset));
-                tracer.doTrace(colobj, from, to, collisionWorld);
+                tracer.doTrace(colobj, from, to, collisionWorld, sweepCandidates);
                 if(tracer.mFraction < 1.0f
                         && tracer.mHitObject->getBroadphaseHandle()->m_collisionFilterGroup != CollisionType_Actor)
                 {
                     const btCollisionObject* standingOn = tracer.mHitObject;
                     PtrHolder* ptrHolder = static_cast<PtrHolder*>(standingOn->getUserPointer());
                     if (ptrHolder)
-                        standingCollisionTracker[ptr] = ptrHolder->getPtr();
+                        standingCollisionTracker[data.mPtr] = ptrHolder->getPtr();
 
                     if (standingOn->getBroadphaseHandle()->m_collisionFilterGroup == CollisionType_Water)
                         physicActor->setWalkingOnWater(true);
@@ -504,6 +533,170 @@ namespace MWPhysics
     };
 
 
+    /// Solves one physics step for a contiguous range of actors.
+    /// @note Other actors are seen at their positions from the end of the previous step, so the results do not depend
+    /// on how the actors are split across threads.
+    class MovementSolverWorkItem : public SceneUtil::WorkItem
+    {
+    public:
+        MovementSolverWorkItem(std::vector<ActorFrameData>& actors, size_t begin, size_t end, float time, const btCollisionWorld* collisionWorld,
+                               std::vector<btBroadphaseProxy*>& sweepCandidates)
+            : mActors(actors)
+            , mBegin(begin)
+            , mEnd(end)
+            , mTime(time)
+            , mCollisionWorld(collisionWorld)
+            , mSweepCandidates(sweepCandidates)
+        {
+        }
+
+        virtual void doWork()
+        {
+            try
+            {
+                for (size_t i=mBegin; i<mEnd; ++i)
+                {
+                    ActorFrameData& data = mActors[i];
+                    data.mPosition = MovementSolver::move(data.mPosition, data, mTime, mCollisionWorld, mStandingCollisions, &mSweepCandidates);
+                }
+            }
+            catch (std::exception& e)
+            {
+                mError = e.what();
+            }
+        }
+
+        /// Standing collisions found by this item. Each actor only ever writes its own entry.
+        std::map<MWWorld::Ptr, MWWorld::Ptr> mStandingCollisions;
+
+        std::string mError;
+
+    private:
+        std::vector<ActorFrameData>& mActors;
+        size_t mBegin;
+        size_t mEnd;
+        float mTime;
+        const btCollisionWorld* mCollisionWorld;
+        std::vector<btBroadphaseProxy*>& mSweepCandidates;
+    };
+
+    static void solveActorMovement(ActorFrameData& data, int numSteps, float physicsDt, btCollisionWorld* collisionWorld,
+                                   std::map<MWWorld::Ptr, MWWorld::Ptr>& standingCollisionTracker)
+    {
+        Actor* physicActor = data.mActor;
+        for (int i=0; i<numSteps; ++i)
+        {
+            data.mPosition = MovementSolver::move(data.mPosition, data, physicsDt, collisionWorld, standingCollisionTracker);
+            if (data.mPosition != physicActor->getPosition())
+                data.mPositionChanged = true;
+            physicActor->setPosition(data.mPosition); // always set even if unchanged to make sure interpolation is correct
+        }
+        if (data.mPositionChanged)
+            collisionWorld->updateSingleAabb(physicActor->getCollisionObject());
+    }
+
+    static void solveMovementInParallel(SceneUtil::WorkQueue* workQueue, unsigned int numThreads, std::vector<ActorFrameData>& actors,
+                                        int numSteps, float physicsDt, btCollisionWorld* collisionWorld,
+                                        std::map<MWWorld::Ptr, MWWorld::Ptr>& standingCollisionTracker)
+    {
+        // The calling thread solves the last chunk itself instead of idling
+        const size_t numChunks = std::min(actors.size(), static_cast<size_t>(numThreads) + 1);
+
+        // One per chunk, reused by every trace of that chunk
+        std::vector<std::vector<btBroadphaseProxy*> > sweepCandidates(numChunks);
+
+        for (int step=0; step<numSteps; ++step)
+        {
+            std::vector<osg::ref_ptr<MovementSolverWorkItem> > items;
+            items.reserve(numChunks);
+            for (size_t chunk=0; chunk<numChunks; ++chunk)
+            {
+                size_t begin = actors.size() * chunk / numChunks;
+                size_t end = actors.size() * (chunk+1) / numChunks;
+                items.push_back(new MovementSolverWorkItem(actors, begin, end, physicsDt, collisionWorld, sweepCandidates[chunk]));
+            }
+
+            for (size_t chunk=0; chunk+1<numChunks; ++chunk)
+                workQueue->addWorkItem(items[chunk], true);
+            items.back()->doWork();
+
+            for (size_t chunk=0; chunk+1<numChunks; ++chunk)
+                items[chunk]->waitTillDone();
+
+            // Collision objects must stay put while any thread is still tracing against them, so apply the results afterwards
+            for (std::vector<ActorFrameData>::iterator it = actors.begin(); it != actors.end(); ++it)
+            {
+                Actor* physicActor = it->mActor;
+                bool positionChanged = it->mPosition != physicActor->getPosition();
+                physicActor->setPosition(it->mPosition); // always set even if unchanged to make sure interpolation is correct
+                if (positionChanged)
+                {
+                    collisionWorld->updateSingleAabb(physicActor->getCollisionObject());
+                    it->mPositionChanged = true;
+                }
+            }
+
+            for (std::vector<osg::ref_ptr<MovementSolverWorkItem> >::const_iterator it = items.begin(); it != items.end(); ++it)
+            {
+                if (!(*it)->mError.empty())
+                    throw std::runtime_error("Failed to solve actor movement: " + (*it)->mError);
+
+                for (std::map<MWWorld::Ptr, MWWorld::Ptr>::const_iterator collision = (*it)->mStandingCollisions.begin();
+                     collision != (*it)->mStandingCollisions.end(); ++collision)
+                    standingCollisionTracker[collision->first] = collision->second;
+            }
+        }
+    }
+
+    /// Solves the movement prepared by PhysicsSystem::applyQueuedMovement for one frame.
+    class PhysicsStepWorkItem : public SceneUtil::WorkItem
+    {
+    public:
+        PhysicsStepWorkItem(int numSteps, float physicsDt, float interpolationFactor, btCollisionWorld* collisionWorld,
+                            std::map<MWWorld::Ptr, MWWorld::Ptr>& standingCollisionTracker,
+                            SceneUtil::WorkQueue* movementWorkQueue, unsigned int numMovementThreads)
+            : mInterpolationFactor(interpolationFactor)
+            , mNumSteps(numSteps)
+            , mPhysicsDt(physicsDt)
+            , mCollisionWorld(collisionWorld)
+            , mStandingCollisionTracker(standingCollisionTracker)
+            , mMovementWorkQueue(movementWorkQueue)
+            , mNumMovementThreads(numMovementThreads)
+        {
+        }
+
+        virtual void doWork()
+        {
+            try
+            {
+                if (mMovementWorkQueue && mActors.size() > 1)
+                    solveMovementInParallel(mMovementWorkQueue, mNumMovementThreads, mActors, mNumSteps, mPhysicsDt,
+                                            mCollisionWorld, mStandingCollisionTracker);
+                else
+                {
+                    for (std::vector<ActorFrameData>::iterator it = mActors.begin(); it != mActors.end(); ++it)
+                        solveActorMovement(*it, mNumSteps, mPhysicsDt, mCollisionWorld, mStandingCollisionTracker);
+                }
+            }
+            catch (std::exception& e)
+            {
+                mError = e.what();
+            }
+        }
+
+        std::vector<ActorFrameData> mActors;
+        float mInterpolationFactor;
+        std::string mError;
+
+    private:
+        int mNumSteps;
+        float mPhysicsDt;
+        btCollisionWorld* mCollisionWorld;
+        std::map<MWWorld::Ptr, MWWorld::Ptr>& mStandingCollisionTracker;
+        SceneUtil::WorkQueue* mMovementWorkQueue;
+        unsigned int mNumMovementThreads;
+    };
+
     // ---------------------------------------------------------------
 
     class HeightField
@@ -679,6 +872,8 @@ namespace MWPhysics
         : mShapeManager(new Resource::BulletShapeManager(resourceSystem->getVFS(), resourceSystem->getSceneManager(), resourceSystem->getNifFileManager()))
         , mResourceSystem(resourceSystem)
         , mDebugDrawEnabled(false)
+        , mNumMovementThreads(0)
+        , mAsyncStepStarted(false)
         , mTimeAccum(0.0f)
         , mWaterHeight(0)
         , mWaterEnabled(false)
@@ -686,6 +881,16 @@ namespace MWPhysics
     {
         mResourceSystem->addResourceManager(mShapeManager.get());
 
+        int numMovementThreads = Settings::Manager::getInt("actor movement threads", "Physics");
+        if (numMovementThreads > 0)
+        {
+            mNumMovementThreads = numMovementThreads;
+            mMovementWorkQueue = new SceneUtil::WorkQueue(numMovementThreads);
+        }
+
+        if (Settings::Manager::getBool("async physics", "Physics"))
+            mAsyncWorkQueue = new SceneUtil::WorkQueue(1);
+
         mCollisionConfiguration = new btDefaultCollisionConfiguration();
         mDispatcher = new btCollisionDispatcher(mCollisionConfiguration);
         mBroadphase = new btDbvtBroadphase();
@@ -699,6 +904,9 @@ namespace MWPhysics
 
     PhysicsSystem::~PhysicsSystem()
     {
+        waitForAsyncStep();
+        mAsyncStep = NULL;
+
         mResourceSystem->removeResourceManager(mShapeManager.get());
 
         if (mWaterCollisionObject.get())
@@ -1164,6 +1372,8 @@ namespace MWPhysics
 
     void PhysicsSystem::remove(const MWWorld::Ptr &ptr)
     {
+        dropPendingMovement(ptr);
+
         ObjectMap::iterator found = mObjects.find(ptr);
         if (found != mObjects.end())
         {
@@ -1222,9 +1432,35 @@ namespace MWPhysics
             mActors.insert(std::make_pair(updated, actor));
         }
 
+        waitForAsyncStep();
+        if (mAsyncStep)
+        {
+            for (std::vector<ActorFrameData>::iterator it = mAsyncStep->mActors.begin(); it != mAsyncStep->mActors.end(); ++it)
+            {
+                if (it->mPtr == old)
+                    it->mPtr = updated;
+            }
+        }
+
         updateCollisionMapPtr(mStandingCollisions, old, updated);
     }
 
+    void PhysicsSystem::dropPendingMovement(const MWWorld::Ptr &ptr)
+    {
+        waitForAsyncStep();
+        if (!mAsyncStep)
+            return;
+
+        std::vector<ActorFrameData>::iterator it = mAsyncStep->mActors.begin();
+        while (it != mAsyncStep->mActors.end())
+        {
+            if (it->mPtr == ptr)
+                it = mAsyncStep->mActors.erase(it);
+            else
+                ++it;
+        }
+    }
+
     Actor *PhysicsSystem::getActor(const MWWorld::Ptr &ptr)
     {
         ActorMap::iterator found = mActors.find(ptr);
@@ -1301,6 +1537,7 @@ namespace MWPhysics
         ActorMap::iterator foundActor = mActors.find(ptr);
         if (foundActor != mActors.end())
         {
+            dropPendingMovement(ptr);
             foundActor->second->updatePosition();
             mCollisionWorld->updateSingleAabb(foundActor->second->getCollisionObject());
             return;
@@ -1348,14 +1585,65 @@ namespace MWPhysics
 
     void PhysicsSystem::clearQueuedMovement()
     {
+        waitForAsyncStep();
+        mAsyncStep = NULL;
+        mAsyncStepStarted = false;
         mMovementQueue.clear();
         mStandingCollisions.clear();
     }
 
+    void PhysicsSystem::startAsyncStep()
+    {
+        if (mAsyncStep && !mAsyncStepStarted)
+        {
+            mAsyncStepStarted = true;
+            mAsyncWorkQueue->addWorkItem(mAsyncStep);
+        }
+    }
+
+    void PhysicsSystem::waitForAsyncStep()
+    {
+        if (mAsyncStep && mAsyncStepStarted)
+            mAsyncStep->waitTillDone();
+    }
+
+    void PhysicsSystem::finishMovement(const std::vector<ActorFrameData>& actors, float interpolationFactor)
+    {
+        for (std::vector<ActorFrameData>::const_iterator it = actors.begin(); it != actors.end(); ++it)
+        {
+            osg::Vec3f interpolated = it->mPosition * interpolationFactor + it->mActor->getPreviousPosition() * (1.f - interpolationFactor);
+
+            float heightDiff = it->mPosition.z() - it->mOldHeight;
+
+            if (heightDiff < 0)
+                it->mPtr.getClass().getCreatureStats(it->mPtr).addToFallHeight(-heightDiff);
+
+            mMovementResults.push_back(std::make_pair(it->mPtr, interpolated));
+        }
+    }
+
     const PtrVelocityList& PhysicsSystem::applyQueuedMovement(float dt)
     {
         mMovementResults.clear();
 
+        if (mAsyncStep)
+        {
+            // Solve it now if startAsyncStep was skipped, e.g. because nothing was rendered
+            if (mAsyncStepStarted)
+                waitForAsyncStep();
+            else
+                mAsyncStep->doWork();
+
+            osg::ref_ptr<PhysicsStepWorkItem> step = mAsyncStep;
+            mAsyncStep = NULL;
+            mAsyncStepStarted = false;
+
+            if (!step->mError.empty())
+                throw std::runtime_error("Failed to solve actor movement: " + step->mError);
+
+            finishMovement(step->mActors, step->mInterpolationFactor);
+        }
+
         mTimeAccum += dt;
         const float physicsDt = 1.f/60.0f;
 
@@ -1371,7 +1659,17 @@ namespace MWPhysics
             mStandingCollisions.clear();
         }
 
+        const bool async = mAsyncWorkQueue.valid();
+        const bool parallel = !async && mMovementWorkQueue && numSteps > 0 && mMovementQueue.size() > 1;
+
         const MWBase::World *world = MWBase::Environment::get().getWorld();
+
+        static const float fSwimHeightScale = world->getStore().get<ESM::GameSetting>().find("fSwimHeightScale")->getFloat();
+        static const float fStromWalkMult = world->getStore().get<ESM::GameSetting>().find("fStromWalkMult")->getFloat();
+        const osg::Vec3f stormDirection = world->isInStorm() ? world->getStormDirection() : osg::Vec3f();
+
+        std::vector<ActorFrameData> actors;
+        actors.reserve(mMovementQueue.size());
         PtrVelocityList::iterator iter = mMovementQueue.begin();
         for(;iter != mMovementQueue.end();++iter)
         {
@@ -1401,33 +1699,54 @@ namespace MWPhysics
             }
             physicActor->setCanWaterWalk(waterCollision);
 
-            // Slow fall reduces fall speed by a factor of (effect magnitude / 200)
-            float slowFall = 1.f - std::max(0.f, std::min(1.f, effects.get(ESM::MagicEffect::SlowFall).getMagnitude() * 0.005f));
-
-            osg::Vec3f position = physicActor->getPosition();
-            float oldHeight = position.z();
-            bool positionChanged = false;
-            for (int i=0; i<numSteps; ++i)
-            {
-                position = MovementSolver::move(position, physicActor->getPtr(), physicActor, iter->second, physicsDt,
-                                                world->isFlying(iter->first),
-                                                waterlevel, slowFall, mCollisionWorld, mStandingCollisions);
-                if (position != physicActor->getPosition())
-                    positionChanged = true;
-                physicActor->setPosition(position); // always set even if unchanged to make sure interpolation is correct
-            }
-            if (positionChanged)
-                mCollisionWorld->updateSingleAabb(physicActor->getCollisionObject());
+            const MWWorld::Ptr& ptr = iter->first;
 
-            float interpolationFactor = mTimeAccum / physicsDt;
-            osg::Vec3f interpolated = position * interpolationFactor + physicActor->getPreviousPosition() * (1.f - interpolationFactor);
+            ActorFrameData data;
+            data.mPtr = ptr;
+            data.mActor = physicActor;
+            data.mMovement = iter->second;
+            data.mRefPosition = ptr.getRefData().getPosition();
+            data.mWaterlevel = waterlevel;
+            data.mSwimLevel = waterlevel + physicActor->getHalfExtents().z()
+                    - (physicActor->getRenderingHalfExtents().z() * 2 * fSwimHeightScale);
+            // Slow fall reduces fall speed by a factor of (effect magnitude / 200)
+            data.mSlowFall = 1.f - std::max(0.f, std::min(1.f, effects.get(ESM::MagicEffect::SlowFall).getMagnitude() * 0.005f));
+            data.mFlying = world->isFlying(ptr);
+            data.mMobile = ptr.getClass().isMobile(ptr);
+            data.mDead = ptr.getClass().getCreatureStats(ptr).isDead();
+            data.mPureWaterCreature = ptr.getClass().isPureWaterCreature(ptr);
+            data.mStormDirection = stormDirection;
+            data.mStormWalkMult = fStromWalkMult;
+            data.mPosition = physicActor->getPosition();
+            data.mOldHeight = data.mPosition.z();
+            data.mPositionChanged = false;
+
+            // The jump request is consumed by this step. Reset it here rather than in finishMovement, which only runs
+            // for an async step once the next frame has already queued its own movement.
+            if (numSteps > 0 && data.mMobile && physicActor->getCollisionMode())
+                ptr.getClass().getMovementSettings(ptr).mPosition[2] = 0;
+
+            if (!async && !parallel)
+                solveActorMovement(data, numSteps, physicsDt, mCollisionWorld, mStandingCollisions);
+
+            actors.push_back(data);
+        }
 
-            float heightDiff = position.z() - oldHeight;
+        const float interpolationFactor = mTimeAccum / physicsDt;
 
-            if (heightDiff < 0)
-                iter->first.getClass().getCreatureStats(iter->first).addToFallHeight(-heightDiff);
+        if (async)
+        {
+            mAsyncStep = new PhysicsStepWorkItem(numSteps, physicsDt, interpolationFactor, mCollisionWorld, mStandingCollisions,
+                                                 mMovementWorkQueue.get(), mNumMovementThreads);
+            mAsyncStep->mActors.swap(actors);
+            mAsyncStepStarted = false;
+        }
+        else
+        {
+            if (parallel && !actors.empty())
+                solveMovementInParallel(mMovementWorkQueue.get(), mNumMovementThreads, actors, numSteps, physicsDt, mCollisionWorld, mStandingCollisions);
 
-            mMovementResults.push_back(std::make_pair(iter->first, interpolated));
+            finishMovement(actors, interpolationFactor);
         }
 
         mMovementQueue.clear();
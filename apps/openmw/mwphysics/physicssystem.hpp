@@ -32,6 +32,7 @@ namespace Resource
 namespace SceneUtil
 {
     class UnrefQueue;
+    class WorkQueue;
 }
 
 class btCollisionWorld;
@@ -48,6 +49,8 @@ namespace MWPhysics
     class HeightField;
     class Object;
     class Actor;
+    class PhysicsStepWorkItem;
+    struct ActorFrameData;
 
     class PhysicsSystem
     {
@@ -142,11 +145,21 @@ namespace MWPhysics
             void queueObjectMovement(const MWWorld::Ptr &ptr, const osg::Vec3f &velocity);
 
             /// Apply all queued movements, then clear the list.
+            /// @note With the "async physics" setting, returns the movement solved by the last startAsyncStep() instead,
+            /// and prepares the queued movement for the next one.
             const PtrVelocityList& applyQueuedMovement(float dt);
 
             /// Clear the queued movements list without applying.
             void clearQueuedMovement();
 
+            /// Start solving the movement prepared by applyQueuedMovement in the background, if "async physics" is enabled.
+            /// @note No other method may be called until waitForAsyncStep() has returned. The step itself only uses the
+            /// state copied by applyQueuedMovement and never accesses a Ptr.
+            void startAsyncStep();
+
+            /// Wait for the step started by startAsyncStep() to complete. Does nothing if no step is running.
+            void waitForAsyncStep();
+
             /// Return true if \a actor has been standing on \a object in this frame
             /// This will trigger whenever the object is directly below the actor.
             /// It doesn't matter if the actor is stationary or moving.
@@ -205,9 +218,23 @@ namespace MWPhysics
             // replaces all occurrences of 'old' in the map by 'updated', no matter if it's a key or value
             void updateCollisionMapPtr(CollisionMap& map, const MWWorld::Ptr &old, const MWWorld::Ptr &updated);
 
+            void finishMovement(const std::vector<ActorFrameData>& actors, float interpolationFactor);
+
+            // Forget the prepared movement of an actor that was removed or moved explicitly
+            void dropPendingMovement(const MWWorld::Ptr& ptr);
+
             PtrVelocityList mMovementQueue;
             PtrVelocityList mMovementResults;
 
+            // Solves actor movement in parallel if set, see the "actor movement threads" setting
+            osg::ref_ptr<SceneUtil::WorkQueue> mMovementWorkQueue;
+            unsigned int mNumMovementThreads;
+
+            // Solves the movement of the previous frame while the next one is rendered, see the "async physics" setting
+            osg::ref_ptr<SceneUtil::WorkQueue> mAsyncWorkQueue;
+            osg::ref_ptr<PhysicsStepWorkItem> mAsyncStep;
+            bool mAsyncStepStarted;
+
             float mTimeAccum;
 
             float mWaterHeight;
@@ -1,9 +1,13 @@
 #include "trace.h"
 
 #include <map>
+#include <vector>
+#include <algorithm>
 
 #include <BulletCollision/CollisionDispatch/btCollisionWorld.h>
 #include <BulletCollision/CollisionShapes/btConvexShape.h>
+#include <BulletCollision/BroadphaseCollision/btBroadphaseInterface.h>
+#include <LinearMath/btTransformUtil.h>
 
 #include "collisiontype.hpp"
 #include "actor.hpp"
@@ -48,8 +52,78 @@ protected:
     const btScalar mMinSlopeDot;
 };
 
+class CollectProxiesCallback : public btBroadphaseAabbCallback
+{
+public:
+    CollectProxiesCallback(std::vector<btBroadphaseProxy*>& proxies)
+        : mProxies(proxies)
+    {
+    }
+
+    virtual bool process(const btBroadphaseProxy* proxy)
+    {
+        mProxies.push_back(const_cast<btBroadphaseProxy*>(proxy));
+        return true;
+    }
+
+private:
+    std::vector<btBroadphaseProxy*>& mProxies;
+};
+
+static bool compareProxyId(const btBroadphaseProxy* a, const btBroadphaseProxy* b)
+{
+    return a->m_uniqueId < b->m_uniqueId;
+}
 
-void ActorTracer::doTrace(const btCollisionObject *actor, const osg::Vec3f& start, const osg::Vec3f& end, const btCollisionWorld* world)
+/// Equivalent of btCollisionWorld::convexSweepTest that may be called from several threads at once, as long
+/// as no collision objects are added, removed or moved meanwhile.
+/// @note btDbvtBroadphase::rayTest keeps its traversal stack in the broadphase, aabbTest does not.
+/// Candidates are visited in the order they were added to the world, so hits at equal distance resolve the same way every time.
+/// @param proxies Scratch buffer for the candidates, owned by the calling thread
+static void threadSafeConvexSweepTest(const btCollisionWorld* world, const btConvexShape* castShape, const btTransform& from,
+                                      const btTransform& to, btCollisionWorld::ConvexResultCallback& resultCallback,
+                                      std::vector<btBroadphaseProxy*>& proxies)
+{
+    // Compute the AABB that encompasses the cast, see btCollisionWorld::convexSweepTest
+    btVector3 linVel, angVel;
+    btTransformUtil::calculateVelocity(from, to, 1.0f, linVel, angVel);
+    btTransform rotation;
+    rotation.setIdentity();
+    rotation.setRotation(from.getRotation());
+    btVector3 castShapeAabbMin, castShapeAabbMax;
+    castShape->calculateTemporalAabb(rotation, btVector3(0,0,0), angVel, 1.0f, castShapeAabbMin, castShapeAabbMax);
+
+    btVector3 aabbMin = from.getOrigin();
+    btVector3 aabbMax = from.getOrigin();
+    aabbMin.setMin(to.getOrigin());
+    aabbMax.setMax(to.getOrigin());
+    aabbMin += castShapeAabbMin;
+    aabbMax += castShapeAabbMax;
+
+    proxies.clear();
+    CollectProxiesCallback collector(proxies);
+    const_cast<btBroadphaseInterface*>(world->getBroadphase())->aabbTest(aabbMin, aabbMax, collector);
+    std::sort(proxies.begin(), proxies.end(), compareProxyId);
+
+    const btScalar allowedPenetration = world->getDispatchInfo().m_allowedCcdPenetration;
+    for (std::vector<btBroadphaseProxy*>::const_iterator it = proxies.begin(); it != proxies.end(); ++it)
+    {
+        if (resultCallback.m_closestHitFraction == btScalar(0.f))
+            break;
+
+        if (!resultCallback.needsCollision(*it))
+            continue;
+
+        const btCollisionObject* collisionObject = static_cast<const btCollisionObject*>((*it)->m_clientObject);
+
+        btCollisionWorld::objectQuerySingle(castShape, from, to, collisionObject, collisionObject->getCollisionShape(),
+                                            collisionObject->getWorldTransform(), resultCallback, allowedPenetration);
+    }
+}
+
+
+void ActorTracer::doTrace(const btCollisionObject *actor, const osg::Vec3f& start, const osg::Vec3f& end, const btCollisionWorld* world,
+                          std::vector<btBroadphaseProxy*>* sweepCandidates)
 {
     const btVector3 btstart = toBullet(start);
     const btVector3 btend = toBullet(end);
@@ -67,8 +141,10 @@ void ActorTracer::doTrace(const btCollisionObject *actor, const osg::Vec3f& star
 
     const btCollisionShape *shape = actor->getCollisionShape();
     assert(shape->isConvex());
-    world->convexSweepTest(static_cast<const btConvexShape*>(shape),
-                                               from, to, newTraceCallback);
+    if (sweepCandidates)
+        threadSafeConvexSweepTest(world, static_cast<const btConvexShape*>(shape), from, to, newTraceCallback, *sweepCandidates);
+    else
+        world->convexSweepTest(static_cast<const btConvexShape*>(shape), from, to, newTraceCallback);
 
     // Copy the hit data over to our trace results struct:
     if(newTraceCallback.hasHit())
@@ -1,10 +1,13 @@
 #ifndef OENGINE_BULLET_TRACE_H
 #define OENGINE_BULLET_TRACE_H
 
+#include <vector>
+
 #include <osg/Vec3f>
 
 class btCollisionObject;
 class btCollisionWorld;
+struct btBroadphaseProxy;
 
 
 namespace MWPhysics
@@ -20,7 +23,10 @@ namespace MWPhysics
 
         float mFraction;
 
-        void doTrace(const btCollisionObject *actor, const osg::Vec3f& start, const osg::Vec3f& end, const btCollisionWorld* world);
+        /// @param sweepCandidates If set, use a sweep that may run on several threads at once, with this buffer
+        /// owned by the calling thread for its candidates. Otherwise btCollisionWorld::convexSweepTest is used.
+        void doTrace(const btCollisionObject *actor, const osg::Vec3f& start, const osg::Vec3f& end, const btCollisionWorld* world,
+                     std::vector<btBroadphaseProxy*>* sweepCandidates = NULL);
         void findGround(const Actor* actor, const osg::Vec3f& start, const osg::Vec3f& end, const btCollisionWorld* world);
     };
 }
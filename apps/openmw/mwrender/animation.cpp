@@ -458,6 +458,8 @@ namespace MWRender
         , mHeadYawRadians(0.f)
         , mHeadPitchRadians(0.f)
         , mAlpha(1.f)
+        , mThrottlingDistance(0.f)
+        , mThrottlingInterval(1)
     {
         for(size_t i = 0;i < sNumBlendMasks;i++)
             mAnimationTimePtr[i].reset(new AnimationTime);
@@ -489,6 +491,14 @@ namespace MWRender
             mSkeleton->setActive(active);
     }
 
+    void Animation::setUpdateThrottling(float distance, unsigned int frameInterval)
+    {
+        mThrottlingDistance = distance;
+        mThrottlingInterval = frameInterval;
+        if (mSkeleton)
+            mSkeleton->setUpdateThrottling(distance, frameInterval);
+    }
+
     void Animation::updatePtr(const MWWorld::Ptr &ptr)
     {
         mPtr = ptr;
@@ -1202,6 +1212,7 @@ namespace MWRender
                 skel = new SceneUtil::Skeleton;
                 skel->addChild(created);
             }
+            skel->setUpdateThrottling(mThrottlingDistance, mThrottlingInterval);
             mSkeleton = skel.get();
             mObjectRoot = skel;
             mInsert->addChild(mObjectRoot);
@@ -271,6 +271,9 @@ protected:
 
     float mAlpha;
 
+    float mThrottlingDistance;
+    unsigned int mThrottlingInterval;
+
     mutable std::map<std::string, float> mAnimVelocities;
 
     osg::ref_ptr<SceneUtil::LightListCallback> mLightListCallback;
@@ -348,6 +351,11 @@ public:
     /// @see SceneUtil::Skeleton::setActive
     void setActive(bool active);
 
+    /// Throttle updates of the object skeleton while it is distant or not visible. Disabled by default, since
+    /// objects that are not rendered by the main camera (e.g. the inventory preview) would not be updated properly.
+    /// @see SceneUtil::Skeleton::setUpdateThrottling
+    void setUpdateThrottling(float distance, unsigned int frameInterval);
+
     osg::Group* getOrCreateObjectRoot();
 
     osg::Group* getObjectRoot();
@@ -1,6 +1,7 @@
 #include "objects.hpp"
 
 #include <cmath>
+#include <algorithm>
 
 #include <osg/Group>
 #include <osg/UserDataContainer>
@@ -8,6 +9,8 @@
 #include <components/sceneutil/positionattitudetransform.hpp>
 #include <components/sceneutil/unrefqueue.hpp>
 
+#include <components/settings/settings.hpp>
+
 #include "../mwworld/ptr.hpp"
 #include "../mwworld/class.hpp"
 
@@ -24,6 +27,8 @@ Objects::Objects(Resource::ResourceSystem* resourceSystem, osg::ref_ptr<osg::Gro
     : mRootNode(rootNode)
     , mResourceSystem(resourceSystem)
     , mUnrefQueue(unrefQueue)
+    , mThrottlingDistance(Settings::Manager::getFloat("distant animation distance", "Animation"))
+    , mThrottlingInterval(std::max(1, Settings::Manager::getInt("distant animation interval", "Animation")))
 {
 }
 
@@ -89,6 +94,7 @@ void Objects::insertCreature(const MWWorld::Ptr &ptr, const std::string &mesh, b
         anim = new CreatureWeaponAnimation(ptr, mesh, mResourceSystem);
     else
         anim = new CreatureAnimation(ptr, mesh, mResourceSystem);
+    anim->setUpdateThrottling(mThrottlingDistance, mThrottlingInterval);
 
     ptr.getClass().getContainerStore(ptr).setContListener(static_cast<ActorAnimation*>(anim.get()));
 
@@ -101,6 +107,7 @@ void Objects::insertNPC(const MWWorld::Ptr &ptr)
     ptr.getRefData().getBaseNode()->setNodeMask(Mask_Actor);
 
     osg::ref_ptr<NpcAnimation> anim (new NpcAnimation(ptr, osg::ref_ptr<osg::Group>(ptr.getRefData().getBaseNode()), mResourceSystem));
+    anim->setUpdateThrottling(mThrottlingDistance, mThrottlingInterval);
 
     ptr.getClass().getInventoryStore(ptr).setInvListener(anim.get(), ptr);
     ptr.getClass().getInventoryStore(ptr).setContListener(anim.get());
@@ -69,6 +69,10 @@ class Objects{
 
     osg::ref_ptr<SceneUtil::UnrefQueue> mUnrefQueue;
 
+    // see Animation::setUpdateThrottling
+    float mThrottlingDistance;
+    unsigned int mThrottlingInterval;
+
     void insertBegin(const MWWorld::Ptr& ptr);
 
 public:
@@ -208,6 +208,7 @@ namespace MWRender
             mViewer->setIncrementalCompileOperation(new osgUtil::IncrementalCompileOperation);
 
         mResourceSystem->getSceneManager()->setIncrementalCompileOperation(mViewer->getIncrementalCompileOperation());
+        mResourceSystem->getSceneManager()->setWorkQueue(mWorkQueue);
 
         mEffectManager.reset(new EffectManager(sceneRoot, mResourceSystem));
 
@@ -288,6 +289,7 @@ namespace MWRender
     RenderingManager::~RenderingManager()
     {
         // let background loading thread finish before we delete anything else
+        mResourceSystem->getSceneManager()->setWorkQueue(NULL);
         mWorkQueue = NULL;
     }
 
@@ -47,7 +47,7 @@ namespace MWScript
     {
         if (!id.empty())
         {
-            return MWBase::Environment::get().getWorld()->getPtr (id, activeOnly);
+            return findReference (id, activeOnly);
         }
         else
         {
@@ -67,7 +67,7 @@ namespace MWScript
     {
         if (!id.empty())
         {
-            return MWBase::Environment::get().getWorld()->getPtr (id, activeOnly);
+            return findReference (id, activeOnly);
         }
         else
         {
@@ -82,6 +82,18 @@ namespace MWScript
         }
     }
 
+    MWWorld::Ptr InterpreterContext::findReference (const std::string& id, bool activeOnly) const
+    {
+        MWBase::World *world = MWBase::Environment::get().getWorld();
+
+        // The player is found without a search anyway
+        if (Misc::StringUtils::ciEqual (id, "player"))
+            return world->getPtr (id, activeOnly);
+
+        // The cache outlives this context, which only exists for a single run of a script
+        return MWBase::Environment::get().getScriptManager()->getReference (id, activeOnly);
+    }
+
     const Locals& InterpreterContext::getMemberLocals (std::string& id, bool global)
         const
     {
@@ -126,8 +138,7 @@ namespace MWScript
     int InterpreterContext::findLocalVariableIndex (const std::string& scriptId,
         const std::string& name, char type) const
     {
-        int index = MWBase::Environment::get().getScriptManager()->getLocals (scriptId).
-            searchIndex (type, name);
+        int index = MWBase::Environment::get().getScriptManager()->getLocalIndex (scriptId, name, type);
 
         if (index!=-1)
             return index;
@@ -371,28 +382,28 @@ namespace MWScript
 
     std::string InterpreterContext::getNPCName() const
     {
-        ESM::NPC npc = *getReferenceImp().get<ESM::NPC>()->mBase;
-        return npc.mName;
+        const ESM::NPC* npc = getReferenceImp().get<ESM::NPC>()->mBase;
+        return npc->mName;
     }
 
     std::string InterpreterContext::getNPCRace() const
     {
-        ESM::NPC npc = *getReferenceImp().get<ESM::NPC>()->mBase;
-        const ESM::Race* race = MWBase::Environment::get().getWorld()->getStore().get<ESM::Race>().find(npc.mRace);
+        const ESM::NPC* npc = getReferenceImp().get<ESM::NPC>()->mBase;
+        const ESM::Race* race = MWBase::Environment::get().getWorld()->getStore().get<ESM::Race>().find(npc->mRace);
         return race->mName;
     }
 
     std::string InterpreterContext::getNPCClass() const
     {
-        ESM::NPC npc = *getReferenceImp().get<ESM::NPC>()->mBase;
-        const ESM::Class* class_ = MWBase::Environment::get().getWorld()->getStore().get<ESM::Class>().find(npc.mClass);
+        const ESM::NPC* npc = getReferenceImp().get<ESM::NPC>()->mBase;
+        const ESM::Class* class_ = MWBase::Environment::get().getWorld()->getStore().get<ESM::Class>().find(npc->mClass);
         return class_->mName;
     }
 
     std::string InterpreterContext::getNPCFaction() const
     {
-        ESM::NPC npc = *getReferenceImp().get<ESM::NPC>()->mBase;
-        const ESM::Faction* faction = MWBase::Environment::get().getWorld()->getStore().get<ESM::Faction>().find(npc.mFaction);
+        const ESM::NPC* npc = getReferenceImp().get<ESM::NPC>()->mBase;
+        const ESM::Faction* faction = MWBase::Environment::get().getWorld()->getStore().get<ESM::Faction>().find(npc->mFaction);
         return faction->mName;
     }
 
@@ -416,8 +427,8 @@ namespace MWScript
     std::string InterpreterContext::getPCName() const
     {
         MWBase::World *world = MWBase::Environment::get().getWorld();
-        ESM::NPC player = *world->getPlayerPtr().get<ESM::NPC>()->mBase;
-        return player.mName;
+        const ESM::NPC* player = world->getPlayerPtr().get<ESM::NPC>()->mBase;
+        return player->mName;
     }
 
     std::string InterpreterContext::getPCRace() const
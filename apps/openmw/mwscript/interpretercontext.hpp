@@ -1,6 +1,8 @@
 #ifndef GAME_SCRIPT_INTERPRETERCONTEXT_H
 #define GAME_SCRIPT_INTERPRETERCONTEXT_H
 
+#include <vector>
+
 #include <components/interpreter/context.hpp>
 
 #include "../mwworld/ptr.hpp"
@@ -27,6 +29,10 @@ namespace MWScript
 
             std::string mTargetId;
 
+            /// Like World::getPtr, but reuses the result of an earlier search as long as it can't be stale.
+            /// @see MWBase::ScriptManager::getReference
+            MWWorld::Ptr findReference (const std::string& id, bool activeOnly) const;
+
             /// If \a id is empty, a reference the script is run from is returned or in case
             /// of a non-local script the reference derived from the target ID.
             MWWorld::Ptr getReferenceImp (const std::string& id = "", bool activeOnly = false,
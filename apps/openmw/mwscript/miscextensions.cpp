@@ -1,6 +1,7 @@
 #include "miscextensions.hpp"
 
 #include <cstdlib>
+#include <sstream>
 
 /*
     Start of tes3mp addition
@@ -25,6 +26,8 @@
 #include <components/esm/loadmgef.hpp>
 #include <components/esm/loadcrea.hpp>
 
+#include <components/misc/scriptprofiler.hpp>
+
 #include "../mwbase/environment.hpp"
 #include "../mwbase/windowmanager.hpp"
 #include "../mwbase/scriptmanager.hpp"
@@ -1089,6 +1092,39 @@ namespace MWScript
             }
         };
 
+        class OpToggleScriptProfiler : public Interpreter::Opcode0
+        {
+        public:
+            virtual void execute (Interpreter::Runtime& runtime)
+            {
+                MWBase::ScriptManager *scriptManager = MWBase::Environment::get().getScriptManager();
+                ::Misc::ScriptProfiler& profiler = scriptManager->getProfiler();
+
+                if (!profiler.isEnabled())
+                {
+                    profiler.clear();
+                    profiler.setEnabled (true);
+                    runtime.getContext().report ("Script Profiler -> On");
+                    return;
+                }
+
+                profiler.setEnabled (false);
+                runtime.getContext().report ("Script Profiler -> Off");
+
+                std::ostringstream summary;
+                profiler.writeSummary (summary, 10);
+
+                std::istringstream lines (summary.str());
+                std::string line;
+                while (std::getline (lines, line))
+                    runtime.getContext().report (line);
+
+                std::string path = scriptManager->writeProfile();
+                if (!path.empty())
+                    runtime.getContext().report ("Call stacks written to " + path);
+            }
+        };
+
         class OpToggleGodMode : public Interpreter::Opcode0
         {
             public:
@@ -1429,6 +1465,7 @@ namespace MWScript
             interpreter.installSegment5 (Compiler::Misc::opcodeShowExplicit, new OpShow<ExplicitRef>);
             interpreter.installSegment5 (Compiler::Misc::opcodeToggleGodMode, new OpToggleGodMode);
             interpreter.installSegment5 (Compiler::Misc::opcodeToggleScripts, new OpToggleScripts);
+            interpreter.installSegment5 (Compiler::Misc::opcodeToggleScriptProfiler, new OpToggleScriptProfiler);
             interpreter.installSegment5 (Compiler::Misc::opcodeDisableLevitation, new OpEnableLevitation<false>);
             interpreter.installSegment5 (Compiler::Misc::opcodeEnableLevitation, new OpEnableLevitation<true>);
             interpreter.installSegment5 (Compiler::Misc::opcodeCast, new OpCast<ImplicitRef>);
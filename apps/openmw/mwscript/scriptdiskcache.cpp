@@ -0,0 +1,208 @@
+#include "scriptdiskcache.hpp"
+
+#include <iostream>
+#include <stdexcept>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <components/misc/stringops.hpp>
+
+namespace
+{
+    // Increase whenever the compiler, the opcodes or the file format change, so that entries written by older
+    // versions are no longer used.
+    const unsigned int sScriptCacheVersion = 2;
+
+    const char sMagic[] = "OMWSCRIPTCACHE";
+
+    // Limit for sizes read from the file, so a damaged file can't cause huge allocations
+    const unsigned int sMaxSize = 1 << 24;
+
+    unsigned long long hashText (const std::string& text)
+    {
+        // 64-bit FNV-1a
+        unsigned long long hash = 14695981039346656037ull;
+        for (std::string::const_iterator iter (text.begin()); iter!=text.end(); ++iter)
+        {
+            hash ^= static_cast<unsigned char> (*iter);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    template<typename T>
+    void writeValue (std::ostream& stream, const T& value)
+    {
+        stream.write (reinterpret_cast<const char *> (&value), sizeof (T));
+    }
+
+    void writeString (std::ostream& stream, const std::string& string)
+    {
+        writeValue (stream, static_cast<unsigned int> (string.size()));
+        stream.write (string.c_str(), string.size());
+    }
+
+    template<typename T>
+    T readValue (std::istream& stream)
+    {
+        T value;
+        if (!stream.read (reinterpret_cast<char *> (&value), sizeof (T)))
+            throw std::runtime_error ("unexpected end of file");
+        return value;
+    }
+
+    unsigned int readSize (std::istream& stream)
+    {
+        unsigned int size = readValue<unsigned int> (stream);
+        if (size>sMaxSize)
+            throw std::runtime_error ("invalid size");
+        return size;
+    }
+
+    std::string readString (std::istream& stream)
+    {
+        std::string string (readSize (stream), '\0');
+        if (!string.empty() && !stream.read (&string[0], string.size()))
+            throw std::runtime_error ("unexpected end of file");
+        return string;
+    }
+
+    const char sTypes[] = { 's', 'l', 'f' };
+}
+
+namespace MWScript
+{
+    ScriptDiskCache::ScriptDiskCache (const std::string& path, const std::string& signature)
+    : mPath (path), mSignature (signature), mChanged (false)
+    {
+        read();
+    }
+
+    bool ScriptDiskCache::find (const std::string& name, const std::string& scriptText,
+        std::vector<Interpreter::Type_Code>& code, Compiler::Locals& locals) const
+    {
+        std::map<std::string, Entry>::const_iterator iter = mEntries.find (Misc::StringUtils::lowerCase (name));
+
+        if (iter==mEntries.end() || iter->second.mTextHash!=hashText (scriptText))
+            return false;
+
+        code = iter->second.mCode;
+        locals = iter->second.mLocals;
+        return true;
+    }
+
+    void ScriptDiskCache::insert (const std::string& name, const std::string& scriptText,
+        const std::vector<Interpreter::Type_Code>& code, const Compiler::Locals& locals)
+    {
+        Entry& entry = mEntries[Misc::StringUtils::lowerCase (name)];
+        entry.mTextHash = hashText (scriptText);
+        entry.mCode = code;
+        entry.mLocals = locals;
+        mChanged = true;
+    }
+
+    void ScriptDiskCache::read()
+    {
+        if (!boost::filesystem::exists (mPath))
+            return;
+
+        try
+        {
+            boost::filesystem::ifstream stream (mPath, std::ios_base::binary);
+            if (!stream)
+                return;
+
+            if (readString (stream)!=sMagic || readValue<unsigned int> (stream)!=sScriptCacheVersion
+                || readString (stream)!=mSignature)
+                return;
+
+            unsigned int count = readSize (stream);
+
+            for (unsigned int i=0; i<count; ++i)
+            {
+                std::string name = readString (stream);
+
+                Entry entry;
+                entry.mTextHash = readValue<unsigned long long> (stream);
+
+                entry.mCode.resize (readSize (stream));
+                if (!entry.mCode.empty() && !stream.read (reinterpret_cast<char *> (&entry.mCode[0]),
+                    entry.mCode.size() * sizeof (Interpreter::Type_Code)))
+                    throw std::runtime_error ("unexpected end of file");
+
+                for (int type=0; type<3; ++type)
+                {
+                    unsigned int variables = readSize (stream);
+                    for (unsigned int j=0; j<variables; ++j)
+                        entry.mLocals.declare (sTypes[type], readString (stream));
+                }
+
+                mEntries.insert (std::make_pair (name, entry));
+            }
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Failed to read script cache '" << mPath << "': " << e.what() << std::endl;
+            mEntries.clear();
+        }
+    }
+
+    void ScriptDiskCache::write()
+    {
+        if (!mChanged)
+            return;
+
+        // write to a temporary file first so that other processes never see an incomplete file
+        std::string tempPath = mPath + ".tmp";
+
+        try
+        {
+            boost::filesystem::create_directories (boost::filesystem::path (mPath).parent_path());
+
+            {
+                boost::filesystem::ofstream stream (tempPath, std::ios_base::binary);
+                if (!stream)
+                    throw std::runtime_error ("can't open file");
+
+                writeString (stream, sMagic);
+                writeValue (stream, sScriptCacheVersion);
+                writeString (stream, mSignature);
+                writeValue (stream, static_cast<unsigned int> (mEntries.size()));
+
+                for (std::map<std::string, Entry>::const_iterator iter (mEntries.begin());
+                    iter!=mEntries.end(); ++iter)
+                {
+                    writeString (stream, iter->first);
+                    writeValue (stream, iter->second.mTextHash);
+
+                    writeValue (stream, static_cast<unsigned int> (iter->second.mCode.size()));
+                    if (!iter->second.mCode.empty())
+                        stream.write (reinterpret_cast<const char *> (&iter->second.mCode[0]),
+                            iter->second.mCode.size() * sizeof (Interpreter::Type_Code));
+
+                    for (int type=0; type<3; ++type)
+                    {
+                        const std::vector<std::string>& variables = iter->second.mLocals.get (sTypes[type]);
+                        writeValue (stream, static_cast<unsigned int> (variables.size()));
+                        for (std::vector<std::string>::const_iterator variable (variables.begin());
+                            variable!=variables.end(); ++variable)
+                            writeString (stream, *variable);
+                    }
+                }
+
+                if (!stream)
+                    throw std::runtime_error ("write error");
+            }
+
+            boost::filesystem::rename (tempPath, mPath);
+            mChanged = false;
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Failed to write script cache '" << mPath << "': " << e.what() << std::endl;
+            boost::system::error_code ec;
+            boost::filesystem::remove (tempPath, ec);
+        }
+    }
+}
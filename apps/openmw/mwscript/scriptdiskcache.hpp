@@ -0,0 +1,56 @@
+#ifndef GAME_SCRIPT_SCRIPTDISKCACHE_H
+#define GAME_SCRIPT_SCRIPTDISKCACHE_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <components/compiler/locals.hpp>
+
+#include <components/interpreter/types.hpp>
+
+namespace MWScript
+{
+    /// \brief Persistent cache of compiled scripts on disk.
+    ///
+    /// All entries are kept in one file, which is read as a whole on construction. An entry is only used if the
+    /// source text of the script is unchanged. Compiling a script also depends on the other records that are loaded
+    /// (globals, IDs, locals of other scripts), so the whole file is ignored if the content signature or the compiler
+    /// version differs.
+    class ScriptDiskCache
+    {
+        public:
+
+            /// \param path File to read the cache from and write it to.
+            /// \param signature Describes the loaded content files.
+            ScriptDiskCache (const std::string& path, const std::string& signature);
+
+            /// \return Was a valid entry for a script with the given source text found?
+            bool find (const std::string& name, const std::string& scriptText,
+                std::vector<Interpreter::Type_Code>& code, Compiler::Locals& locals) const;
+
+            void insert (const std::string& name, const std::string& scriptText,
+                const std::vector<Interpreter::Type_Code>& code, const Compiler::Locals& locals);
+
+            /// Write the cache file, if entries were added since it was read.
+            void write();
+
+        private:
+
+            struct Entry
+            {
+                unsigned long long mTextHash;
+                std::vector<Interpreter::Type_Code> mCode;
+                Compiler::Locals mLocals;
+            };
+
+            std::string mPath;
+            std::string mSignature;
+            std::map<std::string, Entry> mEntries; // by lower case script ID
+            bool mChanged;
+
+            void read();
+    };
+}
+
+#endif
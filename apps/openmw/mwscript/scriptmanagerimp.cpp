@@ -6,6 +6,8 @@
 #include <exception>
 #include <algorithm>
 
+#include <boost/filesystem/fstream.hpp>
+
 #include <components/esm/loadscpt.hpp>
 
 #include <components/misc/stringops.hpp>
@@ -13,20 +15,86 @@
 #include <components/compiler/scanner.hpp>
 #include <components/compiler/context.hpp>
 #include <components/compiler/exception.hpp>
+#include <components/compiler/generator.hpp>
 #include <components/compiler/quickfileparser.hpp>
 
+#include "../mwbase/environment.hpp"
+#include "../mwbase/world.hpp"
+
 #include "../mwworld/esmstore.hpp"
+#include "../mwworld/ptr.hpp"
 
 #include "extensions.hpp"
+#include "interpretercontext.hpp"
+#include "scriptdiskcache.hpp"
+
+namespace
+{
+    struct SelfContainedJob
+    {
+        std::string mName;
+        MWWorld::Ptr mPtr;
+        const std::vector<Interpreter::Type_Code> *mByteCode;
+        const Interpreter::Program *mProgram;
+        unsigned int mInstructions;
+        std::string mError;
+    };
+
+    /// Runs a range of self-contained local scripts.
+    class SelfContainedWorkItem : public SceneUtil::WorkItem
+    {
+    public:
+        SelfContainedWorkItem(const Interpreter::Interpreter& interpreter, std::vector<SelfContainedJob>& jobs,
+            size_t begin, size_t end)
+            : mInterpreter(interpreter)
+            , mJobs(jobs)
+            , mBegin(begin)
+            , mEnd(end)
+        {
+        }
+
+        virtual void doWork()
+        {
+            for (size_t i=mBegin; i<mEnd; ++i)
+            {
+                SelfContainedJob& job = mJobs[i];
+                try
+                {
+                    MWScript::InterpreterContext interpreterContext (&job.mPtr.getRefData().getLocals(), job.mPtr);
+
+                    job.mInstructions = mInterpreter.runDetached(&(*job.mByteCode)[0], job.mByteCode->size(),
+                        *job.mProgram, interpreterContext);
+                }
+                catch (const std::exception& e)
+                {
+                    job.mError = e.what();
+                }
+            }
+        }
+
+    private:
+        const Interpreter::Interpreter& mInterpreter;
+        std::vector<SelfContainedJob>& mJobs;
+        size_t mBegin;
+        size_t mEnd;
+    };
+}
 
 namespace MWScript
 {
+    ScriptManager::CompiledScript::CompiledScript (const std::vector<Interpreter::Type_Code>& byteCode,
+        const Compiler::Locals& locals)
+    : mByteCode (byteCode), mLocals (locals),
+      mSelfContained (Compiler::Generator::isSelfContained (byteCode)),
+      mUsesMemberVariables (Compiler::Generator::usesMemberVariables (byteCode))
+    {}
+
     ScriptManager::ScriptManager (const MWWorld::ESMStore& store,
         Compiler::Context& compilerContext, int warningsMode,
         const std::vector<std::string>& scriptBlacklist)
     : mErrorHandler (std::cerr), mStore (store),
       mCompilerContext (compilerContext), mParser (mErrorHandler, mCompilerContext),
-      mOpcodesInstalled (false), mGlobalScripts (store)
+      mOpcodesInstalled (false), mGlobalScripts (store), mNumThreads (0)
     {
         mErrorHandler.setWarningsMode (warningsMode);
 
@@ -37,6 +105,31 @@ namespace MWScript
         std::sort (mScriptBlacklist.begin(), mScriptBlacklist.end());
     }
 
+    ScriptManager::~ScriptManager()
+    {
+        if (mDiskCache)
+            mDiskCache->write();
+    }
+
+    void ScriptManager::setDiskCache (const std::string& path, const std::string& signature)
+    {
+        mDiskCache.reset (new ScriptDiskCache (path, signature));
+    }
+
+    void ScriptManager::setProfilePath (const std::string& path)
+    {
+        mProfilePath = path;
+    }
+
+    void ScriptManager::setThreads (int threads)
+    {
+        if (threads>0)
+        {
+            mNumThreads = threads;
+            mWorkQueue = new SceneUtil::WorkQueue (threads);
+        }
+    }
+
     bool ScriptManager::compile (const std::string& name)
     {
         mParser.reset();
@@ -44,6 +137,18 @@ namespace MWScript
 
         if (const ESM::Script *script = mStore.get<ESM::Script>().find (name))
         {
+            if (mDiskCache)
+            {
+                std::vector<Interpreter::Type_Code> code;
+                Compiler::Locals locals;
+
+                if (mDiskCache->find (name, script->mScriptText, code, locals))
+                {
+                    mScripts.insert (std::make_pair (name, CompiledScript (code, locals)));
+                    return true;
+                }
+            }
+
             mErrorHandler.setContext(name);
 
             bool Success = true;
@@ -79,7 +184,10 @@ namespace MWScript
             {
                 std::vector<Interpreter::Type_Code> code;
                 mParser.getCode (code);
-                mScripts.insert (std::make_pair (name, std::make_pair (code, mParser.getLocals())));
+                mScripts.insert (std::make_pair (name, CompiledScript (code, mParser.getLocals())));
+
+                if (mDiskCache)
+                    mDiskCache->insert (name, script->mScriptText, code, mParser.getLocals());
 
                 return true;
             }
@@ -88,9 +196,8 @@ namespace MWScript
         return false;
     }
 
-    void ScriptManager::run (const std::string& name, Interpreter::Context& interpreterContext)
+    ScriptManager::CompiledScript *ScriptManager::getCompiledScript (const std::string& name)
     {
-        // compile script
         ScriptCollection::iterator iter = mScripts.find (name);
 
         if (iter==mScripts.end())
@@ -99,35 +206,138 @@ namespace MWScript
             {
                 // failed -> ignore script from now on.
                 std::vector<Interpreter::Type_Code> empty;
-                mScripts.insert (std::make_pair (name, std::make_pair (empty, Compiler::Locals())));
-                return;
+                return &mScripts.insert (std::make_pair (name, CompiledScript (empty, Compiler::Locals()))).first->second;
             }
 
             iter = mScripts.find (name);
             assert (iter!=mScripts.end());
         }
 
+        return &iter->second;
+    }
+
+    void ScriptManager::prepare (CompiledScript& script)
+    {
+        if (!mOpcodesInstalled)
+        {
+            installOpcodes (mInterpreter);
+            mOpcodesInstalled = true;
+        }
+
+        // Opcodes only need to be looked up once per script
+        if (script.mProgram.empty())
+            mInterpreter.prepare (&script.mByteCode[0], script.mByteCode.size(), script.mProgram);
+    }
+
+    void ScriptManager::run (const std::string& name, Interpreter::Context& interpreterContext)
+    {
+        // compile script
+        CompiledScript& script = *getCompiledScript (name);
+
         // execute script
-        if (!iter->second.first.empty())
+        if (!script.mByteCode.empty())
             try
             {
-                if (!mOpcodesInstalled)
-                {
-                    installOpcodes (mInterpreter);
-                    mOpcodesInstalled = true;
-                }
+                prepare (script);
+
+                Misc::ScriptProfiler::Scope scope (mProfiler, name);
 
-                mInterpreter.run (&iter->second.first[0], iter->second.first.size(), interpreterContext);
+                mProfiler.addInstructions (mInterpreter.run (&script.mByteCode[0], script.mByteCode.size(),
+                    script.mProgram, interpreterContext));
             }
             catch (const std::exception& e)
             {
                 std::cerr << "Execution of script " << name << " failed:" << std::endl;
                 std::cerr << e.what() << std::endl;
 
-                iter->second.first.clear(); // don't execute again.
+                script.mByteCode.clear(); // don't execute again.
+                script.mProgram.clear();
+                script.mSelfContained = false;
             }
     }
 
+    bool ScriptManager::isSelfContained (const std::string& name)
+    {
+        return getCompiledScript (name)->mSelfContained;
+    }
+
+    bool ScriptManager::usesMemberVariables (const std::string& name)
+    {
+        return getCompiledScript (name)->mUsesMemberVariables;
+    }
+
+    bool ScriptManager::hasThreads() const
+    {
+        return mWorkQueue.valid();
+    }
+
+    void ScriptManager::runSelfContained (const std::vector<std::pair<std::string, MWWorld::Ptr> >& scripts)
+    {
+        std::vector<SelfContainedJob> jobs;
+        jobs.reserve (scripts.size());
+
+        // Compiling and decoding modifies the script collection, so it has to be done up front
+        for (std::vector<std::pair<std::string, MWWorld::Ptr> >::const_iterator iter (scripts.begin());
+            iter!=scripts.end(); ++iter)
+        {
+            CompiledScript& script = *getCompiledScript (iter->first);
+
+            if (!script.mSelfContained)
+                continue;
+
+            prepare (script);
+
+            SelfContainedJob job;
+            job.mName = iter->first;
+            job.mPtr = iter->second;
+            job.mByteCode = &script.mByteCode;
+            job.mProgram = &script.mProgram;
+            job.mInstructions = 0;
+            jobs.push_back (job);
+        }
+
+        if (jobs.empty())
+            return;
+
+        // The profiler can't be used from other threads, so the scripts are recorded as one call
+        Misc::ScriptProfiler::Scope scope (mProfiler, "[self-contained scripts]");
+
+        // The calling thread runs the last chunk itself instead of idling
+        const size_t numChunks = std::min (jobs.size(), static_cast<size_t> (mNumThreads) + 1);
+
+        std::vector<osg::ref_ptr<SelfContainedWorkItem> > items;
+        items.reserve (numChunks);
+        for (size_t chunk=0; chunk<numChunks; ++chunk)
+        {
+            size_t begin = jobs.size() * chunk / numChunks;
+            size_t end = jobs.size() * (chunk+1) / numChunks;
+            items.push_back (new SelfContainedWorkItem (mInterpreter, jobs, begin, end));
+        }
+
+        for (size_t chunk=0; chunk+1<numChunks; ++chunk)
+            mWorkQueue->addWorkItem (items[chunk], true);
+        items.back()->doWork();
+
+        for (size_t chunk=0; chunk+1<numChunks; ++chunk)
+            items[chunk]->waitTillDone();
+
+        for (std::vector<SelfContainedJob>::const_iterator iter (jobs.begin()); iter!=jobs.end(); ++iter)
+        {
+            mProfiler.addInstructions (iter->mInstructions);
+
+            if (iter->mError.empty())
+                continue;
+
+            std::cerr << "Execution of script " << iter->mName << " failed:" << std::endl;
+            std::cerr << iter->mError << std::endl;
+
+            CompiledScript& script = mScripts.find (iter->mName)->second;
+            script.mByteCode.clear(); // don't execute again.
+            script.mProgram.clear();
+            script.mSelfContained = false;
+        }
+    }
+
     std::pair<int, int> ScriptManager::compileAll()
     {
         int count = 0;
@@ -146,6 +356,9 @@ namespace MWScript
                     ++success;
             }
 
+        if (mDiskCache)
+            mDiskCache->write();
+
         return std::make_pair (count, success);
     }
 
@@ -157,7 +370,7 @@ namespace MWScript
             ScriptCollection::iterator iter = mScripts.find (name2);
 
             if (iter!=mScripts.end())
-                return iter->second.second;
+                return iter->second.mLocals;
         }
 
         {
@@ -171,6 +384,10 @@ namespace MWScript
         {
             Compiler::Locals locals;
 
+            std::vector<Interpreter::Type_Code> code;
+            if (mDiskCache && mDiskCache->find (name2, script->mScriptText, code, locals))
+                return mOtherLocals.insert (std::make_pair (name2, locals)).first->second;
+
             mErrorHandler.setContext(name2 + "[local variables]");
 
             std::istringstream stream (script->mScriptText);
@@ -187,6 +404,79 @@ namespace MWScript
         throw std::logic_error ("script " + name + " does not exist");
     }
 
+    int ScriptManager::getLocalIndex (const std::string& name, const std::string& variable, char type)
+    {
+        std::string name2 = Misc::StringUtils::lowerCase (name);
+
+        LocalIndexCache::iterator script = mLocalIndices.find (name2);
+
+        if (script==mLocalIndices.end())
+            script = mLocalIndices.insert (std::make_pair (name2, LocalIndexCache::mapped_type())).first;
+
+        LocalIndexCache::mapped_type::const_iterator iter = script->second.find (variable);
+
+        if (iter==script->second.end())
+        {
+            const Compiler::Locals& locals = getLocals (name2);
+
+            char variableType = locals.getType (variable);
+
+            if (variableType==' ')
+                return -1;
+
+            iter = script->second.insert (std::make_pair (variable,
+                std::make_pair (variableType, locals.getIndex (variable)))).first;
+        }
+
+        // A variable name is declared with only one type per script
+        return iter->second.first==type ? iter->second.second : -1;
+    }
+
+    MWWorld::Ptr ScriptManager::getReference (const std::string& id, bool activeOnly)
+    {
+        MWBase::World *world = MWBase::Environment::get().getWorld();
+
+        unsigned int cellChangeCount = world->getCellChangeCount();
+
+        std::pair<std::string, bool> key (id, activeOnly);
+
+        ReferenceCache::iterator iter = mReferences.find (key);
+
+        // Objects may have been moved or unloaded with their cell, and deleted objects aren't found
+        // by a search either.
+        if (iter!=mReferences.end() && iter->second.mCellChangeCount==cellChangeCount &&
+            iter->second.mPtr.getRefData().getCount()>0)
+            return iter->second.mPtr;
+
+        // Throws for unknown IDs, so only touch the cache once the search succeeded
+        MWWorld::Ptr ptr = world->getPtr (id, activeOnly);
+
+        CachedReference& reference = mReferences[key];
+        reference.mPtr = ptr;
+        reference.mCellChangeCount = cellChangeCount;
+        return ptr;
+    }
+
+    Misc::ScriptProfiler& ScriptManager::getProfiler()
+    {
+        return mProfiler;
+    }
+
+    std::string ScriptManager::writeProfile()
+    {
+        boost::filesystem::ofstream stream (mProfilePath);
+
+        mProfiler.writeFolded (stream);
+
+        if (!stream)
+        {
+            std::cerr << "Failed to write script profile '" << mProfilePath << "'" << std::endl;
+            return "";
+        }
+
+        return mProfilePath;
+    }
+
     GlobalScripts& ScriptManager::getGlobalScripts()
     {
         return mGlobalScripts;
@@ -2,6 +2,7 @@
 #define GAME_SCRIPT_SCRIPTMANAGER_H
 
 #include <map>
+#include <memory>
 #include <string>
 
 #include <components/compiler/streamerrorhandler.hpp>
@@ -10,8 +11,14 @@
 #include <components/interpreter/interpreter.hpp>
 #include <components/interpreter/types.hpp>
 
+#include <components/misc/scriptprofiler.hpp>
+
+#include <components/sceneutil/workqueue.hpp>
+
 #include "../mwbase/scriptmanager.hpp"
 
+#include "../mwworld/ptr.hpp"
+
 #include "globalscripts.hpp"
 
 namespace MWWorld
@@ -32,6 +39,8 @@ namespace Interpreter
 
 namespace MWScript
 {
+    class ScriptDiskCache;
+
     class ScriptManager : public MWBase::ScriptManager
     {
             Compiler::StreamErrorHandler mErrorHandler;
@@ -41,13 +50,49 @@ namespace MWScript
             Interpreter::Interpreter mInterpreter;
             bool mOpcodesInstalled;
 
-            typedef std::pair<std::vector<Interpreter::Type_Code>, Compiler::Locals> CompiledScript;
+            struct CompiledScript
+            {
+                std::vector<Interpreter::Type_Code> mByteCode;
+                Compiler::Locals mLocals;
+                Interpreter::Program mProgram; // mByteCode decoded for mInterpreter, prepared on the first run
+                bool mSelfContained;
+                bool mUsesMemberVariables;
+
+                CompiledScript(const std::vector<Interpreter::Type_Code>& byteCode, const Compiler::Locals& locals);
+            };
+
             typedef std::map<std::string, CompiledScript> ScriptCollection;
 
             ScriptCollection mScripts;
             GlobalScripts mGlobalScripts;
             std::map<std::string, Compiler::Locals> mOtherLocals;
+
+            // Resolved member variables: lower case script ID -> variable name -> (type, index). Script locals
+            // never change once compiled, so neither does the index of a variable.
+            typedef std::map<std::string, std::map<std::string, std::pair<char, int> > > LocalIndexCache;
+            LocalIndexCache mLocalIndices;
+
+            struct CachedReference
+            {
+                unsigned int mCellChangeCount; // World::getCellChangeCount when mPtr was found
+                MWWorld::Ptr mPtr;
+            };
+
+            // References scripts have accessed by ID: (ID, active only) -> last search result
+            typedef std::map<std::pair<std::string, bool>, CachedReference> ReferenceCache;
+            ReferenceCache mReferences;
             std::vector<std::string> mScriptBlacklist;
+            std::unique_ptr<ScriptDiskCache> mDiskCache;
+            osg::ref_ptr<SceneUtil::WorkQueue> mWorkQueue;
+            int mNumThreads;
+            Misc::ScriptProfiler mProfiler;
+            std::string mProfilePath;
+
+            CompiledScript *getCompiledScript (const std::string& name);
+            ///< Compile script first, if not compiled yet. Scripts that fail to compile have no byte code.
+
+            void prepare (CompiledScript& script);
+            ///< Install the opcodes and decode \a script for mInterpreter, if not done yet.
 
         public:
 
@@ -55,6 +100,19 @@ namespace MWScript
                 Compiler::Context& compilerContext, int warningsMode,
                 const std::vector<std::string>& scriptBlacklist);
 
+            virtual ~ScriptManager();
+            ///< Writes scripts compiled since the disk cache was read.
+
+            void setDiskCache (const std::string& path, const std::string& signature);
+            ///< Reuse compiled scripts from earlier runs and store newly compiled ones in the file at \a path.
+            /// \param signature Describes the loaded content files; the cache is ignored if it differs from the stored one.
+
+            void setProfilePath (const std::string& path);
+            ///< File written by writeProfile.
+
+            void setThreads (int threads);
+            ///< Number of background threads for self-contained local scripts (0: run them on the main thread).
+
             virtual void run (const std::string& name, Interpreter::Context& interpreterContext);
             ///< Run the script with the given name (compile first, if not compiled yet)
 
@@ -69,6 +127,34 @@ namespace MWScript
             virtual const Compiler::Locals& getLocals (const std::string& name);
             ///< Return locals for script \a name.
 
+            virtual int getLocalIndex (const std::string& name, const std::string& variable, char type);
+            ///< Return index of local variable \a variable of type \a type in script \a name,
+            /// or -1 if there is no such variable.
+
+            virtual MWWorld::Ptr getReference (const std::string& id, bool activeOnly);
+            ///< Like World::getPtr, but reuses the result of an earlier search as long as it can't be stale.
+
+            virtual bool isSelfContained (const std::string& name);
+            ///< Does the script only use its own local variables (compile first, if not compiled yet)?
+            /// Self-contained local scripts of different references can run at the same time.
+
+            virtual bool usesMemberVariables (const std::string& name);
+            ///< Does the script access local variables of other scripts (compile first, if not compiled yet)?
+
+            virtual bool hasThreads() const;
+            ///< Are threads available for running self-contained scripts?
+
+            virtual void runSelfContained (const std::vector<std::pair<std::string, MWWorld::Ptr> >& scripts);
+            ///< Run the given self-contained local scripts (name, reference), spread over the available threads.
+            /// Other scripts in \a scripts are ignored.
+
+            virtual Misc::ScriptProfiler& getProfiler();
+            ///< Profiler for the scripts run by name.
+
+            virtual std::string writeProfile();
+            ///< Write the call stacks recorded by the profiler to a file, for flame graph tools.
+            /// \return Path of the file, or an empty string if it could not be written.
+
             virtual GlobalScripts& getGlobalScripts();
     };
 }
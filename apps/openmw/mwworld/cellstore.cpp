@@ -1126,9 +1126,9 @@ namespace MWWorld
         return mPathgridGraph.isPointConnected(start, end);
     }
 
-    std::list<ESM::Pathgrid::Point> CellStore::aStarSearch(const int start, const int end) const
+    bool CellStore::aStarSearch(const int start, const int end, std::vector<int>& path) const
     {
-        return mPathgridGraph.aStarSearch(start, end);
+        return mPathgridGraph.aStarSearch(start, end, path);
     }
 
     void CellStore::setFog(ESM::FogState *fog)
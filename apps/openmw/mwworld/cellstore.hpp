@@ -438,7 +438,8 @@ namespace MWWorld
 
             bool isPointConnected(const int start, const int end) const;
 
-            std::list<ESM::Pathgrid::Point> aStarSearch(const int start, const int end) const;
+            /// @see MWMechanics::PathgridGraph::aStarSearch
+            bool aStarSearch(const int start, const int end, std::vector<int>& path) const;
 
         private:
 
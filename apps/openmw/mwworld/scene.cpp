@@ -264,6 +264,7 @@ namespace MWWorld
 
         MWBase::Environment::get().getSoundManager()->stopSound (*iter);
         mActiveCells.erase(*iter);
+        ++mCellChangeCount;
 
         /*
             Start of tes3mp addition
@@ -283,6 +284,7 @@ namespace MWWorld
         if(result.second)
         {
             std::cout << "Loading cell " << cell->getCell()->getDescription() << std::endl;
+            ++mCellChangeCount;
 
             float verts = ESM::Land::LAND_SIZE;
             float worldsize = ESM::Land::REAL_SIZE;
@@ -357,6 +359,7 @@ namespace MWWorld
             unloadCell (active++);
         assert(mActiveCells.empty());
         mCurrentCell = NULL;
+        ++mCellChangeCount; // the cells themselves are about to be destroyed
 
         mPreloader->clear();
     }
@@ -519,7 +522,7 @@ namespace MWWorld
     }
 
     Scene::Scene (MWRender::RenderingManager& rendering, MWPhysics::PhysicsSystem *physics)
-    : mCurrentCell (0), mCellChanged (false), mPhysics(physics), mRendering(rendering)
+    : mCurrentCell (0), mCellChanged (false), mCellChangeCount (0), mPhysics(physics), mRendering(rendering)
     , mPreloadTimer(0.f)
     , mHalfGridSize(Settings::Manager::getInt("exterior cell load distance", "Cells"))
     , mCellLoadingThreshold(1024.f)
@@ -552,6 +555,11 @@ namespace MWWorld
         return mCellChanged;
     }
 
+    unsigned int Scene::getCellChangeCount() const
+    {
+        return mCellChangeCount;
+    }
+
     const Scene::CellStoreCollection& Scene::getActiveCells() const
     {
         return mActiveCells;
@@ -710,29 +718,6 @@ namespace MWWorld
         return Ptr();
     }
 
-    class PreloadMeshItem : public SceneUtil::WorkItem
-    {
-    public:
-        PreloadMeshItem(const std::string& mesh, Resource::SceneManager* sceneManager)
-            : mMesh(mesh), mSceneManager(sceneManager)
-        {
-        }
-
-        virtual void doWork()
-        {
-            try
-            {
-                mSceneManager->getTemplate(mMesh);
-            }
-            catch (std::exception& e)
-            {
-            }
-        }
-    private:
-        std::string mMesh;
-        Resource::SceneManager* mSceneManager;
-    };
-
     void Scene::preload(const std::string &mesh, bool useAnim)
     {
         std::string mesh_ = mesh;
@@ -740,7 +725,7 @@ namespace MWWorld
             mesh_ = Misc::ResourceHelpers::correctActorModelPath(mesh_, mRendering.getResourceSystem()->getVFS());
 
         if (!mRendering.getResourceSystem()->getSceneManager()->checkLoaded(mesh_, mRendering.getReferenceTime()))
-            mRendering.getWorkQueue()->addWorkItem(new PreloadMeshItem(mesh_, mRendering.getResourceSystem()->getSceneManager()));
+            mRendering.getResourceSystem()->getSceneManager()->requestTemplate(mesh_);
     }
 
     void Scene::preloadCells(float dt)
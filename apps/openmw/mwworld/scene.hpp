@@ -55,6 +55,7 @@ namespace MWWorld
             CellStore* mCurrentCell; // the cell the player is in
             CellStoreCollection mActiveCells;
             bool mCellChanged;
+            unsigned int mCellChangeCount;
             MWPhysics::PhysicsSystem *mPhysics;
             MWRender::RenderingManager& mRendering;
             std::unique_ptr<CellPreloader> mPreloader;
@@ -106,6 +107,9 @@ namespace MWWorld
             bool hasCellChanged() const;
             ///< Has the set of active cells changed, since the last frame?
 
+            unsigned int getCellChangeCount() const;
+            ///< Incremented whenever a cell is loaded or unloaded.
+
             void changeToInteriorCell (const std::string& cellName, const ESM::Position& position, bool adjustPlayerPos, bool changeEvent=true);
             ///< Move to interior cell.
             /// @param changeEvent Set cellChanged flag?
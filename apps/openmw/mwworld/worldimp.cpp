@@ -173,7 +173,8 @@ namespace MWWorld
       mGodMode(false), mScriptsEnabled(true), mContentFiles (contentFiles), mUserDataPath(userDataPath),
       mActivationDistanceOverride (activationDistanceOverride), mStartupScript(startupScript),
       mStartCell (startCell), mDistanceToFacedObject(-1), mTeleportEnabled(true),
-      mLevitationEnabled(true), mGoToJail(false), mDaysInPrison(0), mSpellPreloadTimer(0.f)
+      mLevitationEnabled(true), mGoToJail(false), mDaysInPrison(0), mSpellPreloadTimer(0.f),
+      mObjectCellChanges(0)
     {
         mPhysics = new MWPhysics::PhysicsSystem(resourceSystem, rootNode);
         mRendering = new MWRender::RenderingManager(viewer, rootNode, resourceSystem, workQueue, &mFallback, resourcePath);
@@ -613,6 +614,11 @@ namespace MWWorld
         return mWorldScene->hasCellChanged();
     }
 
+    unsigned int World::getCellChangeCount() const
+    {
+        return mWorldScene->getCellChangeCount() + mObjectCellChanges;
+    }
+
     void World::setGlobalInt (const std::string& name, int value)
     {
         if (name=="gamehour")
@@ -1224,6 +1230,8 @@ namespace MWWorld
 
             removeContainerScripts(ptr);
 
+            ++mObjectCellChanges;
+
             if (isPlayer)
             {
                 if (!newCell->isExterior())
@@ -1314,6 +1322,8 @@ namespace MWWorld
             mWorldScene->playerMoved(vec);
         }
 
+        MWBase::Environment::get().getMechanicsManager()->updatePosition(newPtr);
+
         return newPtr;
     }
 
@@ -1729,6 +1739,16 @@ namespace MWWorld
         }
     }
 
+    void World::startPhysicsStep()
+    {
+        mPhysics->startAsyncStep();
+    }
+
+    void World::finishPhysicsStep()
+    {
+        mPhysics->waitForAsyncStep();
+    }
+
     void World::updatePlayer(bool paused)
     {
         MWWorld::Ptr player = getPlayerPtr();
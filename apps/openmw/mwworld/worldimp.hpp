@@ -173,6 +173,8 @@ namespace MWWorld
 
             float mSpellPreloadTimer;
 
+            unsigned int mObjectCellChanges; // objects moved to a different cell
+
             float feetToGameUnits(float feet);
             float getActivationDistancePlusTelekinesis();
 
@@ -235,6 +237,9 @@ namespace MWWorld
             virtual bool hasCellChanged() const;
             ///< Has the set of active cells changed, since the last frame?
 
+            virtual unsigned int getCellChangeCount() const;
+            ///< Incremented whenever a cell is loaded or unloaded, or an object is moved to a different cell.
+
             virtual bool isCellExterior() const;
 
             virtual bool isCellQuasiExterior() const;
@@ -465,6 +470,13 @@ namespace MWWorld
 
             virtual void update (float duration, bool paused);
 
+            virtual void startPhysicsStep();
+            ///< Solve the movement prepared during this frame in the background, if the "async physics" setting is enabled.
+            /// The world must not be used until finishPhysicsStep() returns.
+
+            virtual void finishPhysicsStep();
+            ///< Wait for the step started by startPhysicsStep() to complete.
+
             virtual MWWorld::Ptr placeObject (const MWWorld::ConstPtr& object, float cursorX, float cursorY, int amount);
             ///< copy and place an object into the gameworld at the specified cursor position
             /// @param object
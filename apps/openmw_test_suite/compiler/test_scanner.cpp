@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include "components/compiler/context.hpp"
+#include "components/compiler/exception.hpp"
+#include "components/compiler/nullerrorhandler.hpp"
+#include "components/compiler/parser.hpp"
+#include "components/compiler/scanner.hpp"
+
+namespace
+{
+    class TestContext : public Compiler::Context
+    {
+        public:
+
+            virtual bool canDeclareLocals() const { return true; }
+
+            virtual char getGlobalType (const std::string& name) const { return ' '; }
+
+            virtual std::pair<char, bool> getMemberType (const std::string& name, const std::string& id) const
+            {
+                return std::make_pair (' ', false);
+            }
+
+            virtual bool isId (const std::string& name) const { return false; }
+
+            virtual bool isJournalId (const std::string& name) const { return false; }
+    };
+
+    /// Records every token as "type value line:column literal".
+    class RecordingParser : public Compiler::Parser
+    {
+            std::vector<std::string> mTokens;
+
+            bool record (const std::string& token, const Compiler::TokenLoc& loc)
+            {
+                std::ostringstream stream;
+                stream << token << " " << loc.mLine << ":" << loc.mColumn << " " << loc.mLiteral;
+                mTokens.push_back (stream.str());
+                return true;
+            }
+
+        public:
+
+            RecordingParser (Compiler::ErrorHandler& errorHandler, const Compiler::Context& context)
+            : Parser (errorHandler, context) {}
+
+            virtual bool parseInt (int value, const Compiler::TokenLoc& loc, Compiler::Scanner& scanner)
+            {
+                std::ostringstream stream;
+                stream << "int " << value;
+                return record (stream.str(), loc);
+            }
+
+            virtual bool parseFloat (float value, const Compiler::TokenLoc& loc, Compiler::Scanner& scanner)
+            {
+                std::ostringstream stream;
+                stream << "float " << value;
+                return record (stream.str(), loc);
+            }
+
+            virtual bool parseName (const std::string& name, const Compiler::TokenLoc& loc,
+                Compiler::Scanner& scanner)
+            {
+                return record ("name " + name, loc);
+            }
+
+            virtual bool parseKeyword (int keyword, const Compiler::TokenLoc& loc, Compiler::Scanner& scanner)
+            {
+                std::ostringstream stream;
+                stream << "keyword " << keyword;
+                return record (stream.str(), loc);
+            }
+
+            virtual bool parseSpecial (int code, const Compiler::TokenLoc& loc, Compiler::Scanner& scanner)
+            {
+                std::ostringstream stream;
+                stream << "special " << code;
+                return record (stream.str(), loc);
+            }
+
+            virtual bool parseComment (const std::string& comment, const Compiler::TokenLoc& loc,
+                Compiler::Scanner& scanner)
+            {
+                return record ("comment " + comment, loc);
+            }
+
+            virtual void parseEOF (Compiler::Scanner& scanner)
+            {
+                mTokens.push_back ("eof");
+            }
+
+            const std::vector<std::string>& getTokens() const { return mTokens; }
+    };
+
+    std::vector<std::string> scan (const std::string& text)
+    {
+        TestContext context;
+        Compiler::NullErrorHandler errorHandler;
+        RecordingParser parser (errorHandler, context);
+
+        std::istringstream stream (text);
+        Compiler::Scanner scanner (errorHandler, stream);
+
+        try
+        {
+            scanner.scan (parser);
+        }
+        catch (const Compiler::SourceException&)
+        {
+            std::vector<std::string> tokens = parser.getTokens();
+            tokens.push_back ("error");
+            return tokens;
+        }
+
+        return parser.getTokens();
+    }
+}
+
+TEST(CompilerScannerTest, tokens_have_locations_and_literals)
+{
+    std::vector<std::string> tokens = scan ("set Foo to 12 ; comment\n\"some name\" != 0.5\n");
+
+    ASSERT_EQ(11u, tokens.size());
+    EXPECT_EQ("keyword 13 0:3 set", tokens[0]);
+    EXPECT_EQ("name Foo 0:7 Foo", tokens[1]);
+    EXPECT_EQ("keyword 14 0:10 to", tokens[2]);
+    EXPECT_EQ("int 12 0:13 12", tokens[3]);
+    EXPECT_EQ("comment ; comment 0:23 ; comment", tokens[4]);
+    EXPECT_EQ("special 0 1:0 <newline>", tokens[5]);
+    EXPECT_EQ("name some name 1:11 \"some name\"", tokens[6]);
+    EXPECT_EQ("special 4 1:14 !=", tokens[7]);
+    EXPECT_EQ("float 0.5 1:18 0.5", tokens[8]);
+    EXPECT_EQ("special 0 2:0 <newline>", tokens[9]);
+    EXPECT_EQ("eof", tokens[10]);
+}
+
+TEST(CompilerScannerTest, integers_saturate)
+{
+    std::vector<std::string> tokens = scan ("99999999999 2147483647");
+
+    ASSERT_EQ(3u, tokens.size());
+    EXPECT_EQ("int 2147483647 0:11 99999999999", tokens[0]);
+    EXPECT_EQ("int 2147483647 0:22 2147483647", tokens[1]);
+    EXPECT_EQ("eof", tokens[2]);
+}
+
+TEST(CompilerScannerTest, names_may_start_with_digits_and_contain_dashes)
+{
+    std::vector<std::string> tokens = scan ("12abc a-b c - d\r\n");
+
+    ASSERT_EQ(7u, tokens.size());
+    EXPECT_EQ("name 12abc 0:5 12abc", tokens[0]);
+    EXPECT_EQ("name a-b 0:9 a-b", tokens[1]);
+    EXPECT_EQ("name c 0:11 c", tokens[2]);
+    EXPECT_EQ("special 10 0:13 -", tokens[3]);
+    EXPECT_EQ("name d 0:15 d", tokens[4]);
+    EXPECT_EQ("special 0 1:0 <newline>", tokens[5]);
+    EXPECT_EQ("eof", tokens[6]);
+}
+
+TEST(CompilerScannerTest, incomplete_tokens_at_the_end_are_errors)
+{
+    std::vector<std::string> tokens = scan ("x =");
+
+    ASSERT_EQ(2u, tokens.size());
+    EXPECT_EQ("name x 0:1 x", tokens[0]);
+    EXPECT_EQ("error", tokens[1]);
+
+    tokens = scan ("\"unterminated\nx");
+
+    ASSERT_EQ(1u, tokens.size());
+    EXPECT_EQ("error", tokens[0]);
+}
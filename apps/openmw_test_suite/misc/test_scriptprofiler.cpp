@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include "components/misc/scriptprofiler.hpp"
+
+TEST(ScriptProfilerTest, disabled_profiler_records_nothing)
+{
+    Misc::ScriptProfiler profiler;
+
+    {
+        Misc::ScriptProfiler::Scope scope (profiler, "outer");
+        profiler.addInstructions (5);
+    }
+
+    EXPECT_TRUE(profiler.getScripts().empty());
+}
+
+TEST(ScriptProfilerTest, nested_calls_count_self_instructions)
+{
+    Misc::ScriptProfiler profiler;
+    profiler.setEnabled (true);
+
+    for (int i=0; i<2; ++i)
+    {
+        Misc::ScriptProfiler::Scope outer (profiler, "outer");
+        profiler.addInstructions (3);
+
+        {
+            Misc::ScriptProfiler::Scope inner (profiler, "inner");
+            profiler.addInstructions (10);
+        }
+
+        profiler.addInstructions (1);
+    }
+
+    const std::map<std::string, Misc::ScriptProfiler::Stats>& scripts = profiler.getScripts();
+    ASSERT_EQ(2u, scripts.size());
+
+    EXPECT_EQ(2u, scripts.find ("outer")->second.mCalls);
+    EXPECT_EQ(8u, scripts.find ("outer")->second.mInstructions);
+    EXPECT_EQ(2u, scripts.find ("inner")->second.mCalls);
+    EXPECT_EQ(20u, scripts.find ("inner")->second.mInstructions);
+    EXPECT_GE(scripts.find ("outer")->second.mTotalTime, scripts.find ("inner")->second.mTotalTime);
+}
+
+TEST(ScriptProfilerTest, folded_stacks_use_separator)
+{
+    Misc::ScriptProfiler profiler;
+    profiler.setEnabled (true);
+
+    {
+        Misc::ScriptProfiler::Scope outer (profiler, "outer;script");
+        Misc::ScriptProfiler::Scope inner (profiler, "inner");
+
+        // make sure both calls take at least a microsecond
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds (2)) {}
+    }
+
+    std::ostringstream stream;
+    profiler.writeFolded (stream);
+
+    EXPECT_NE(std::string::npos, stream.str().find ("outer:script;inner "));
+}
@@ -65,3 +65,22 @@ TEST_F(KeywordSearchTest, keyword_test_conflict_resolution3)
     ASSERT_TRUE (matches.size() == 1);
     ASSERT_TRUE (std::string(matches.front().mBeg, matches.front().mEnd) == "bar lock");
 }
+
+TEST_F(KeywordSearchTest, keyword_test_prefix_seeded_last)
+{
+    // a keyword that is a prefix of an already seeded keyword must still be found
+    MWDialogue::KeywordSearch<std::string, int> search;
+    search.seed("dwemer", 1);
+    search.seed("dwe", 2);
+
+    std::string text = "dwe and dwemer";
+
+    std::vector<MWDialogue::KeywordSearch<std::string, int>::Match> matches;
+    search.highlightKeywords(text.begin(), text.end(), matches);
+
+    ASSERT_TRUE (matches.size() == 2);
+    ASSERT_TRUE (std::string(matches.front().mBeg, matches.front().mEnd) == "dwe");
+    ASSERT_TRUE (matches.front().mValue == 2);
+    ASSERT_TRUE (std::string(matches.rbegin()->mBeg, matches.rbegin()->mEnd) == "dwemer");
+    ASSERT_TRUE (matches.rbegin()->mValue == 1);
+}
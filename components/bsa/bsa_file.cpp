@@ -28,9 +28,50 @@
 #include <boost/filesystem/path.hpp>
 #include <boost/filesystem/fstream.hpp>
 
+#include <components/files/memorymappedfile.hpp>
+#include <components/files/memorystream.hpp>
+
 using namespace std;
 using namespace Bsa;
 
+namespace
+{
+    /// Zero-copy stream over a file inside a memory mapped archive. Keeps the mapping alive while the stream is in use.
+    struct MappedFileStream : Files::IMemStream
+    {
+        MappedFileStream(const std::shared_ptr<Files::MemoryMappedFile>& mapping, size_t offset, size_t size)
+            : Files::MemBuf(mapping->data() + offset, size)
+            , Files::IMemStream(mapping->data() + offset, size)
+            , mMapping(mapping)
+        {
+        }
+
+        std::shared_ptr<Files::MemoryMappedFile> mMapping;
+    };
+}
+
+size_t BSAFile::ihash::operator()(const char *s) const
+{
+    // FNV-1a over the lower-cased characters
+    size_t hash = 2166136261u;
+    for (; *s; ++s)
+    {
+        hash ^= static_cast<unsigned char>(Misc::StringUtils::toLower(*s));
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+bool BSAFile::ieqstr::operator()(const char *s1, const char *s2) const
+{
+    for (; *s1 && *s2; ++s1, ++s2)
+    {
+        if (Misc::StringUtils::toLower(*s1) != Misc::StringUtils::toLower(*s2))
+            return false;
+    }
+    return *s1 == *s2;
+}
+
 
 /// Error handling
 void BSAFile::fail(const string &msg)
@@ -130,6 +171,7 @@ void BSAFile::readHeader()
 
     // Set up the the FileStruct table
     files.resize(filenum);
+    lookup.reserve(filenum);
     for(size_t i=0;i<filenum;i++)
     {
         FileStruct &fs = files[i];
@@ -164,6 +206,17 @@ void BSAFile::open(const string &file)
 {
     filename = file;
     readHeader();
+
+    try
+    {
+        mapping.reset(new Files::MemoryMappedFile);
+        mapping->open(filename.c_str());
+    }
+    catch (std::exception&)
+    {
+        // fall back to reading through file streams
+        mapping.reset();
+    }
 }
 
 Files::IStreamPtr BSAFile::getFile(const char *file)
@@ -173,12 +226,13 @@ Files::IStreamPtr BSAFile::getFile(const char *file)
     if(i == -1)
         fail("File not found: " + string(file));
 
-    const FileStruct &fs = files[i];
-
-    return Files::openConstrainedFileStream (filename.c_str (), fs.offset, fs.fileSize);
+    return getFile(&files[i]);
 }
 
 Files::IStreamPtr BSAFile::getFile(const FileStruct *file)
 {
+    if (mapping && file->offset + file->fileSize <= mapping->size())
+        return Files::IStreamPtr(new MappedFileStream(mapping, file->offset, file->fileSize));
+
     return Files::openConstrainedFileStream (filename.c_str (), file->offset, file->fileSize);
 }
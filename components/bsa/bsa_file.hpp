@@ -27,12 +27,18 @@
 #include <stdint.h>
 #include <string>
 #include <vector>
-#include <map>
+#include <memory>
+#include <unordered_map>
 
 #include <components/misc/stringops.hpp>
 
 #include <components/files/constrainedfilestream.hpp>
 
+namespace Files
+{
+    class MemoryMappedFile;
+}
+
 
 namespace Bsa
 {
@@ -69,20 +75,29 @@ private:
     /// Used for error messages
     std::string filename;
 
+    /// Case insensitive string hash
+    struct ihash
+    {
+        size_t operator()(const char *s) const;
+    };
+
     /// Case insensitive string comparison
-    struct iltstr
+    struct ieqstr
     {
-        bool operator()(const char *s1, const char *s2) const
-        { return Misc::StringUtils::ciLess(s1, s2); }
+        bool operator()(const char *s1, const char *s2) const;
     };
 
-    /** A map used for fast file name lookup. The value is the index into
-        the files[] vector above. The iltstr ensures that file name
+    /** A hash map used for fast file name lookup. The value is the index into
+        the files[] vector above. The ihash and ieqstr ensure that file name
         checks are case insensitive.
     */
-    typedef std::map<const char*, int, iltstr> Lookup;
+    typedef std::unordered_map<const char*, int, ihash, ieqstr> Lookup;
     Lookup lookup;
 
+    /// Read-only mapping of the whole archive, used to serve file contents without copying.
+    /// Empty if the archive could not be mapped, in which case files are read through file streams instead.
+    std::shared_ptr<Files::MemoryMappedFile> mapping;
+
     /// Error handling
     void fail(const std::string &msg);
 
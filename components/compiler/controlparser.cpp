@@ -1,7 +1,5 @@
 #include "controlparser.hpp"
 
-#include <algorithm>
-#include <iterator>
 #include <stdexcept>
 
 #include "scanner.hpp"
@@ -16,49 +14,43 @@ namespace Compiler
         if (keyword==Scanner::K_endif || keyword==Scanner::K_elseif ||
             keyword==Scanner::K_else)
         {
-            std::pair<Codes, Codes> entry;
+            mIfCode.push_back (std::pair<Codes, Codes>());
+            std::pair<Codes, Codes>& entry = mIfCode.back();
 
             if (mState!=IfElseBodyState)
                 mExprParser.append (entry.first);
 
-            std::copy (mCodeBlock.begin(), mCodeBlock.end(),
-                std::back_inserter (entry.second));
-
-            mIfCode.push_back (entry);
-
-            mCodeBlock.clear();
+            entry.second.swap (mCodeBlock);
 
             if (keyword==Scanner::K_endif)
             {
-                // store code for if-cascade
-                Codes codes;
+                // store code for if-cascade; every block jumps over the blocks after it, so the jumps
+                // are added from the last block on
+                std::size_t size = 0;
 
                 for (IfCodes::reverse_iterator iter (mIfCode.rbegin());
                     iter!=mIfCode.rend(); ++iter)
                 {
-                    Codes block;
-
                     if (iter!=mIfCode.rbegin())
-                        Generator::jump (iter->second, codes.size()+1);
+                        Generator::jump (iter->second, size+1);
 
                     if (!iter->first.empty())
                     {
                         // if or elseif
-                        std::copy (iter->first.begin(), iter->first.end(),
-                            std::back_inserter (block));
-                        Generator::jumpOnZero (block, iter->second.size()+1);
+                        Generator::jumpOnZero (iter->first, iter->second.size()+1);
                     }
 
-                    std::copy (iter->second.begin(), iter->second.end(),
-                        std::back_inserter (block));
+                    size += iter->first.size() + iter->second.size();
+                }
 
-                   std::swap (codes, block);
+                mCode.reserve (mCode.size()+size);
 
-                   std::copy (block.begin(), block.end(), std::back_inserter (codes));
+                for (IfCodes::const_iterator iter (mIfCode.begin()); iter!=mIfCode.end(); ++iter)
+                {
+                    mCode.insert (mCode.end(), iter->first.begin(), iter->first.end());
+                    mCode.insert (mCode.end(), iter->second.begin(), iter->second.end());
                 }
 
-                std::copy (codes.begin(), codes.end(), std::back_inserter (mCode));
-
                 mIfCode.clear();
                 mState = IfEndifState;
             }
@@ -109,15 +101,15 @@ namespace Compiler
 
             Generator::jump (loop, -static_cast<int> (mCodeBlock.size()+expr.size()));
 
-            std::copy (expr.begin(), expr.end(), std::back_inserter (mCode));
+            mCode.insert (mCode.end(), expr.begin(), expr.end());
 
             Codes skip;
 
             Generator::jumpOnZero (skip, mCodeBlock.size()+loop.size()+1);
 
-            std::copy (skip.begin(), skip.end(), std::back_inserter (mCode));
+            mCode.insert (mCode.end(), skip.begin(), skip.end());
 
-            std::copy (mCodeBlock.begin(), mCodeBlock.end(), std::back_inserter (mCode));
+            mCode.insert (mCode.end(), mCodeBlock.begin(), mCodeBlock.end());
 
             Codes loop2;
 
@@ -127,7 +119,7 @@ namespace Compiler
                 throw std::logic_error (
                     "internal compiler error: failed to generate a while loop");
 
-            std::copy (loop2.begin(), loop2.end(), std::back_inserter (mCode));
+            mCode.insert (mCode.end(), loop2.begin(), loop2.end());
 
             mState = WhileEndwhileState;
             return true;
@@ -166,7 +158,7 @@ namespace Compiler
 
     void ControlParser::appendCode (std::vector<Interpreter::Type_Code>& code) const
     {
-        std::copy (mCode.begin(), mCode.end(), std::back_inserter (code));
+        code.insert (code.end(), mCode.begin(), mCode.end());
     }
 
     bool ControlParser::parseName (const std::string& name, const TokenLoc& loc, Scanner& scanner)
@@ -3,8 +3,6 @@
 #include <stdexcept>
 #include <cassert>
 #include <algorithm>
-#include <stack>
-#include <iterator>
 
 #include <components/misc/stringops.hpp>
 
@@ -740,7 +738,7 @@ namespace Compiler
         while (!mOperators.empty())
             pop();
 
-        std::copy (mCode.begin(), mCode.end(), std::back_inserter (code));
+        code.insert (code.end(), mCode.begin(), mCode.end());
 
         assert (mOperands.size()==1);
         return mOperands[0];
@@ -757,7 +755,7 @@ namespace Compiler
         DiscardParser discardParser (getErrorHandler(), getContext());
         JunkParser junkParser (getErrorHandler(), getContext(), ignoreKeyword);
 
-        std::stack<std::vector<Interpreter::Type_Code> > stack;
+        std::vector<std::vector<Interpreter::Type_Code> > stack;
 
         for (std::string::const_iterator iter (arguments.begin()); iter!=arguments.end();
             ++iter)
@@ -782,10 +780,8 @@ namespace Compiler
 
                 if (*iter!='x')
                 {
-                    std::vector<Interpreter::Type_Code> tmp;
-                    stringParser.append (tmp);
-
-                    stack.push (tmp);
+                    stack.push_back (std::vector<Interpreter::Type_Code>());
+                    stringParser.append (stack.back());
 
                     if (optional)
                         ++optionalCount;
@@ -838,28 +834,22 @@ namespace Compiler
                 if (optional && parser.isEmpty())
                     break;
 
-                std::vector<Interpreter::Type_Code> tmp;
+                stack.push_back (std::vector<Interpreter::Type_Code>());
+                std::vector<Interpreter::Type_Code>& tmp = stack.back();
 
                 char type = parser.append (tmp);
 
                 if (type!=*iter)
                     Generator::convert (tmp, type, *iter);
 
-                stack.push (tmp);
-
                 if (optional)
                     ++optionalCount;
             }
         }
 
-        while (!stack.empty())
-        {
-            std::vector<Interpreter::Type_Code>& tmp = stack.top();
-
-            std::copy (tmp.begin(), tmp.end(), std::back_inserter (code));
-
-            stack.pop();
-        }
+        for (std::vector<std::vector<Interpreter::Type_Code> >::const_reverse_iterator iter (stack.rbegin());
+            iter!=stack.rend(); ++iter)
+            code.insert (code.end(), iter->begin(), iter->end());
 
         return optionalCount;
     }
@@ -1,11 +1,10 @@
 #include "generator.hpp"
 
 #include <cassert>
-#include <algorithm>
-#include <iterator>
 #include <stdexcept>
 
 #include "literals.hpp"
+#include "opcodes.hpp"
 
 namespace
 {
@@ -351,6 +350,132 @@ namespace
     {
         code.push_back (Compiler::Generator::segment5 (57));
     }
+
+    bool isSelfContainedCode (Interpreter::Type_Code code)
+    {
+        // push int, jump forward, jump backward
+        if ((code>>30)==0)
+            return (code>>24)<=2;
+
+        if ((code>>26)!=0x32)
+            return false;
+
+        switch (code & 0x3ffffff)
+        {
+            case 0: case 1: case 2: // store local
+            case 3: case 6: case 7: case 8: case 17: case 18: // conversion, negation
+            case 4: case 5: // fetch literal
+            case 9: case 10: case 11: case 12: case 13: case 14: case 15: case 16: case 19: // arithmetic
+            case 20: case 24: case 25: // return, skip
+            case 21: case 22: case 23: // fetch local
+            case 26: case 27: case 28: case 29: case 30: case 31: // compare
+            case 32: case 33: case 34: case 35: case 36: case 37:
+            case 50: // GetSecondsPassed
+
+                return true;
+        }
+
+        return false;
+    }
+
+    bool isMemberCode (Interpreter::Type_Code code)
+    {
+        if ((code>>26)!=0x32)
+            return false;
+
+        unsigned int opcode = code & 0x3ffffff;
+        return opcode>=59 && opcode<=70;
+    }
+
+    int getStateChangesOfCode (Interpreter::Type_Code code)
+    {
+        // push int, jump forward, jump backward
+        if ((code>>30)==0)
+            return (code>>24)<=2 ? 0 : Compiler::Generator::StateChange_Other;
+
+        if ((code>>26)==0x30)
+        {
+            switch ((code>>8) & 0x3ffff)
+            {
+                case 0: // message box
+
+                    return 0;
+
+                case Compiler::Dialogue::opcodeChoice:
+
+                    return Compiler::Generator::StateChange_Dialogue;
+            }
+
+            return Compiler::Generator::StateChange_Other;
+        }
+
+        if ((code>>26)!=0x32)
+            return Compiler::Generator::StateChange_Other;
+
+        switch (code & 0x3ffffff)
+        {
+            case 0: case 1: case 2: // store local
+            case 59: case 60: case 61: // store member
+            case 65: case 66: case 67: // store member of a global script
+
+                return Compiler::Generator::StateChange_Locals;
+
+            case 39: case 40: case 41: // store global
+
+                return Compiler::Generator::StateChange_Globals;
+
+            case Compiler::Dialogue::opcodeJournal:
+            case Compiler::Dialogue::opcodeSetJournalIndex:
+
+                return Compiler::Generator::StateChange_Journal;
+
+            case Compiler::Container::opcodeAddItem:
+            case Compiler::Container::opcodeAddItemExplicit:
+            case Compiler::Container::opcodeRemoveItem:
+            case Compiler::Container::opcodeRemoveItemExplicit:
+
+                return Compiler::Generator::StateChange_Items;
+
+            case 3: case 6: case 7: case 8: case 17: case 18: // conversion, negation
+            case 4: case 5: // fetch literal
+            case 9: case 10: case 11: case 12: case 13: case 14: case 15: case 16: case 19: // arithmetic
+            case 20: case 24: case 25: // return, skip
+            case 21: case 22: case 23: // fetch local
+            case 26: case 27: case 28: case 29: case 30: case 31: // compare
+            case 32: case 33: case 34: case 35: case 36: case 37:
+            case 38: // MenuMode
+            case 42: case 43: case 44: // fetch global
+            case 45: // Random
+            case 46: // ScriptRunning
+            case 49: case 57: // GetDistance
+            case 50: // GetSecondsPassed
+            case 53: case 56: // GetDisabled
+            case 62: case 63: case 64: // fetch member
+            case 68: case 69: case 70: // fetch member of a global script
+            case Compiler::Dialogue::opcodeGetJournalIndex:
+            case Compiler::Container::opcodeGetItemCount:
+            case Compiler::Container::opcodeGetItemCountExplicit:
+
+                return 0;
+
+            case Compiler::Dialogue::opcodeAddTopic:
+
+                return Compiler::Generator::StateChange_Topics;
+
+            case Compiler::Stats::opcodeModDisposition:
+            case Compiler::Stats::opcodeModDispositionExplicit:
+            case Compiler::Stats::opcodeSetDisposition:
+            case Compiler::Stats::opcodeSetDispositionExplicit:
+
+                return Compiler::Generator::StateChange_Disposition;
+
+            case Compiler::Dialogue::opcodeGoodbye:
+
+                return Compiler::Generator::StateChange_Dialogue;
+        }
+
+        return Compiler::Generator::StateChange_Other;
+    }
 }
 
 namespace Compiler
@@ -382,7 +507,7 @@ namespace Compiler
         {
             opPushInt (code, localIndex);
 
-            std::copy (value.begin(), value.end(), std::back_inserter (code));
+            code.insert (code.end(), value.begin(), value.end());
 
             if (localType!=valueType)
             {
@@ -657,7 +782,7 @@ namespace Compiler
 
             opPushInt (code, index);
 
-            std::copy (value.begin(), value.end(), std::back_inserter (code));
+            code.insert (code.end(), value.begin(), value.end());
 
             if (localType!=valueType)
             {
@@ -736,7 +861,7 @@ namespace Compiler
 
             opPushInt (code, index);
 
-            std::copy (value.begin(), value.end(), std::back_inserter (code));
+            code.insert (code.end(), value.begin(), value.end());
 
             if (localType!=valueType)
             {
@@ -894,5 +1019,42 @@ namespace Compiler
                 opDisableExplicit (code);
             }
         }
+
+        bool isSelfContained (const CodeContainer& code)
+        {
+            if (code.size()<4 || code.size()-4<code[0])
+                return false;
+
+            for (CodeContainer::const_iterator iter (code.begin()+4); iter!=code.begin()+4+code[0]; ++iter)
+                if (!isSelfContainedCode (*iter))
+                    return false;
+
+            return true;
+        }
+
+        bool usesMemberVariables (const CodeContainer& code)
+        {
+            if (code.size()<4 || code.size()-4<code[0])
+                return false;
+
+            for (CodeContainer::const_iterator iter (code.begin()+4); iter!=code.begin()+4+code[0]; ++iter)
+                if (isMemberCode (*iter))
+                    return true;
+
+            return false;
+        }
+
+        int getStateChanges (const CodeContainer& code)
+        {
+            if (code.size()<4 || code.size()-4<code[0])
+                return StateChange_Other;
+
+            int changes = 0;
+
+            for (CodeContainer::const_iterator iter (code.begin()+4); iter!=code.begin()+4+code[0]; ++iter)
+                changes |= getStateChangesOfCode (*iter);
+
+            return changes;
+        }
     }
 }
@@ -124,6 +124,30 @@ namespace Compiler
         void enable (CodeContainer& code, Literals& literals, const std::string& id);
 
         void disable (CodeContainer& code, Literals& literals, const std::string& id);
+
+        bool isSelfContained (const CodeContainer& code);
+        ///< Does the compiled script \a code (including header) only use its own local variables, literals,
+        /// arithmetic, control flow and the frame duration? Such a script doesn't affect anything but its own
+        /// locals and can run concurrently with other self-contained scripts.
+
+        bool usesMemberVariables (const CodeContainer& code);
+        ///< Does the compiled script \a code (including header) access local variables of other scripts?
+
+        enum StateChange
+        {
+            StateChange_Locals = 1, ///< local variables of any script
+            StateChange_Globals = 2,
+            StateChange_Journal = 4,
+            StateChange_Items = 8, ///< items added to or removed from an inventory
+            StateChange_Topics = 16, ///< topics known to the player
+            StateChange_Disposition = 32,
+            StateChange_Dialogue = 64, ///< choices offered and ending the conversation
+            StateChange_Other = 128 ///< anything else, including all instructions that are not classified
+        };
+
+        int getStateChanges (const CodeContainer& code);
+        ///< Which state can the compiled script \a code (including header) change? Returns a combination of
+        /// StateChange flags. Only the instructions that are common in dialogue result scripts are classified.
     }
 }
 
@@ -1,8 +1,6 @@
 #include "output.hpp"
 
 #include <cassert>
-#include <algorithm>
-#include <iterator>
 
 #include "locals.hpp"
 
@@ -27,7 +25,7 @@ namespace Compiler
         code.push_back (static_cast<Interpreter::Type_Code> (mLiterals.getStringSize()/4));
         
         // code
-        std::copy (mCode.begin(), mCode.end(), std::back_inserter (code));
+        code.insert (code.end(), mCode.begin(), mCode.end());
         
         // literals
         mLiterals.append (code);
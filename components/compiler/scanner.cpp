@@ -5,6 +5,7 @@
 #include <sstream>
 #include <algorithm>
 #include <iterator>
+#include <limits>
 
 #include "exception.hpp"
 #include "errorhandler.hpp"
@@ -17,24 +18,29 @@ namespace Compiler
 {
     bool Scanner::get (char& c)
     {
-        mStream.get (c);
-
-        if (!mStream.good())
+        // like a stream, stop for good once the end has been reached
+        if (mEof || mPos>=mSource.size())
+        {
+            mEof = true;
             return false;
+        }
 
-        mPrevLoc =mLoc;
+        c = mSource[mPos++];
+
+        mPrevColumn = mLoc.mColumn;
+        mPrevLine = mLoc.mLine;
+        mPrevLiteralStart = mLiteralStart;
 
         if (c=='\n')
         {
             mStrictKeywords = false;
             mLoc.mColumn = 0;
             ++mLoc.mLine;
-            mLoc.mLiteral.clear();
+            mLiteralStart = mPos;
         }
         else
         {
             ++mLoc.mColumn;
-            mLoc.mLiteral += c;
         }
 
         return true;
@@ -42,8 +48,25 @@ namespace Compiler
 
     void Scanner::putback (char c)
     {
-        mStream.putback (c);
-        mLoc = mPrevLoc;
+        // At the end the position still moves back, so the literal ends where it did before the last get,
+        // but mEof keeps the character from being read again.
+        assert (mPos>0 && mSource[mPos-1]==c);
+        --mPos;
+
+        mLoc.mColumn = mPrevColumn;
+        mLoc.mLine = mPrevLine;
+        mLiteralStart = mPrevLiteralStart;
+    }
+
+    const TokenLoc& Scanner::getTokenLoc()
+    {
+        mLoc.mLiteral.assign (mSource, mLiteralStart, mPos-mLiteralStart);
+        return mLoc;
+    }
+
+    void Scanner::clearLiteral()
+    {
+        mLiteralStart = mPos;
     }
 
     bool Scanner::scanToken (Parser& parser)
@@ -89,9 +112,7 @@ namespace Compiler
         }
         else if (c==';')
         {
-            std::string comment;
-
-            comment += c;
+            std::size_t start = mPos-1;
 
             while (get (c))
             {
@@ -100,24 +121,22 @@ namespace Compiler
                     putback (c);
                     break;
                 }
-                else
-                    comment += c;
             }
 
-            TokenLoc loc (mLoc);
-            mLoc.mLiteral.clear();
+            TokenLoc loc (getTokenLoc());
+            clearLiteral();
 
-            return parser.parseComment (comment, loc, *this);
+            return parser.parseComment (mSource.substr (start, mPos-start), loc, *this);
         }
         else if (isWhitespace (c))
         {
-            mLoc.mLiteral.clear();
+            clearLiteral();
             return true;
         }
         else if (c==':')
         {
             // treat : as a whitespace :(
-            mLoc.mLiteral.clear();
+            clearLiteral();
             return true;
         }
         else if (std::isalpha (c) || c=='_' || c=='"')
@@ -126,7 +145,7 @@ namespace Compiler
 
             if (scanName (c, parser, cont))
             {
-                mLoc.mLiteral.clear();
+                clearLiteral();
                 return cont;
             }
         }
@@ -136,7 +155,7 @@ namespace Compiler
 
             if (scanInt (c, parser, cont))
             {
-                mLoc.mLiteral.clear();
+                clearLiteral();
                 return cont;
             }
         }
@@ -150,13 +169,13 @@ namespace Compiler
 
             if (scanSpecial (c, parser, cont))
             {
-                mLoc.mLiteral.clear();
+                clearLiteral();
                 return cont;
             }
         }
 
-        TokenLoc loc (mLoc);
-        mLoc.mLiteral.clear();
+        TokenLoc loc (getTokenLoc());
+        clearLiteral();
 
         mErrorHandler.error ("syntax error", loc);
         throw SourceException();
@@ -165,8 +184,7 @@ namespace Compiler
     bool Scanner::scanInt (char c, Parser& parser, bool& cont)
     {
         assert(c != '\0');
-        std::string value;
-        value += c;
+        std::size_t start = mPos-1;
 
         bool error = false;
 
@@ -174,12 +192,10 @@ namespace Compiler
         {
             if (std::isdigit (c))
             {
-                value += c;
             }
             else if (c!='-' && isStringCharacter (c))
             {
                 error = true;
-                value += c;
             }
             else if (c=='.')
             {
@@ -188,7 +204,7 @@ namespace Compiler
                     putback (c);
                     break;
                 }
-                return scanFloat (value, parser, cont);
+                return scanFloat (mSource.substr (start, mPos-1-start), parser, cont);
             }
             else
             {
@@ -201,20 +217,32 @@ namespace Compiler
         {
             /// workaround that allows names to begin with digits
             /// \todo disable
-            TokenLoc loc (mLoc);
-            mLoc.mLiteral.clear();
-            cont = parser.parseName (value, loc, *this);
+            TokenLoc loc (getTokenLoc());
+            clearLiteral();
+            cont = parser.parseName (mSource.substr (start, mPos-start), loc, *this);
             return true;
 //            return false;
         }
 
-        TokenLoc loc (mLoc);
-        mLoc.mLiteral.clear();
-
-        std::istringstream stream (value);
+        TokenLoc loc (getTokenLoc());
+        clearLiteral();
 
+        // saturate like reading from a stream does
+        const int max = std::numeric_limits<int>::max();
         int intValue = 0;
-        stream >> intValue;
+
+        for (std::size_t i=start; i<mPos; ++i)
+        {
+            int digit = mSource[i]-'0';
+
+            if (intValue>(max-digit)/10)
+            {
+                intValue = max;
+                break;
+            }
+
+            intValue = intValue*10 + digit;
+        }
 
         cont = parser.parseInt (intValue, loc, *this);
         return true;
@@ -248,8 +276,8 @@ namespace Compiler
         if (empty || error)
             return false;
 
-        TokenLoc loc (mLoc);
-        mLoc.mLiteral.clear();
+        TokenLoc loc (getTokenLoc());
+        clearLiteral();
 
         std::istringstream stream (value);
 
@@ -281,18 +309,54 @@ namespace Compiler
 
     bool Scanner::scanName (char c, Parser& parser, bool& cont)
     {
-        std::string name;
-        name += c;
+        std::size_t start = mPos-1;
+        bool quoted = c=='"';
 
-        if (!scanName (name))
-            return false;
+        while (get (c))
+        {
+            if (quoted)
+            {
+                if (c=='"')
+                    break;
+// ignoring escape sequences for now, because they are messing up stupid Windows path names.
+//                else if (c=='\\')
+//                {
+//                    if (!get (c))
+//                    {
+//                        mErrorHandler.error ("incomplete escape sequence", getTokenLoc());
+//                        return false;
+//                    }
+//                }
+                else if (c=='\n')
+                {
+                    mErrorHandler.error ("incomplete string or name", getTokenLoc());
+                    return false;
+                }
+            }
+            else if (!isStringCharacter (c))
+            {
+                putback (c);
+                break;
+            }
+        }
+
+        TokenLoc loc (getTokenLoc());
+        clearLiteral();
 
-        TokenLoc loc (mLoc);
-        mLoc.mLiteral.clear();
+        std::size_t end = mPos;
 
-        if (name.size()>=2 && name[0]=='"' && name[name.size()-1]=='"')
+        if (end-start>=2 && quoted && mSource[end-1]=='"')
+        {
+            ++start;
+            --end;
+        }
+        else
+            quoted = false;
+
+        std::string name (mSource, start, end-start);
+
+        if (quoted)
         {
-            name = name.substr (1, name.size()-2);
 // allow keywords enclosed in ""
 /// \todo optionally disable
             if (mStrictKeywords)
@@ -330,52 +394,6 @@ namespace Compiler
         return true;
     }
 
-    bool Scanner::scanName (std::string& name)
-    {
-        char c;
-        bool error = false;
-
-        while (get (c))
-        {
-            if (!name.empty() && name[0]=='"')
-            {
-                if (c=='"')
-                {
-                    name += c;
-                    break;
-                }
-// ignoring escape sequences for now, because they are messing up stupid Windows path names.
-//                else if (c=='\\')
-//                {
-//                    if (!get (c))
-//                    {
-//                        error = true;
-//                        mErrorHandler.error ("incomplete escape sequence", mLoc);
-//                        break;
-//                    }
-//                }
-                else if (c=='\n')
-                {
-                    error = true;
-                    mErrorHandler.error ("incomplete string or name", mLoc);
-                    break;
-                }
-            }
-            else if (!(c=='"' && name.empty()))
-            {
-                if (!isStringCharacter (c))
-                {
-                    putback (c);
-                    break;
-                }
-            }
-
-            name += c;
-        }
-
-        return !error;
-    }
-
     bool Scanner::scanSpecial (char c, Parser& parser, bool& cont)
     {
         int special = -1;
@@ -411,7 +429,7 @@ namespace Compiler
                 else if (c == '>' || c == '<')  // Treat => and =< as ==
                 {
                     special = S_cmpEQ;
-                    mErrorHandler.warning (std::string("invalid operator =") + c + ", treating it as ==", mLoc);
+                    mErrorHandler.warning (std::string("invalid operator =") + c + ", treating it as ==", getTokenLoc());
                 }
                 else
                 {
@@ -483,7 +501,7 @@ namespace Compiler
             }
             else
             {
-                mErrorHandler.error ("Invalid character", mLoc);
+                mErrorHandler.error ("Invalid character", getTokenLoc());
                 return false;
             }
         }
@@ -544,11 +562,11 @@ namespace Compiler
         else
             return false;
 
-        if (special==S_newline)
-            mLoc.mLiteral = "<newline>";
+        TokenLoc loc (getTokenLoc());
+        clearLiteral();
 
-        TokenLoc loc (mLoc);
-        mLoc.mLiteral.clear();
+        if (special==S_newline)
+            loc.mLiteral = "<newline>";
 
         cont = parser.parseSpecial (special, loc, *this);
 
@@ -563,7 +581,8 @@ namespace Compiler
             /// \todo disable this when doing more stricter compiling. Also, find out who is
             /// responsible for allowing it in the first place and meet up with that person in
             /// a dark alley.
-            (c=='-' && (!lookAhead || isStringCharacter (mStream.peek(), false)));
+            (c=='-' && (!lookAhead ||
+                (!mEof && mPos<mSource.size() && isStringCharacter (mSource[mPos], false))));
     }
 
     bool Scanner::isWhitespace (char c)
@@ -575,8 +594,10 @@ namespace Compiler
 
     Scanner::Scanner (ErrorHandler& errorHandler, std::istream& inputStream,
         const Extensions *extensions)
-    : mErrorHandler (errorHandler), mStream (inputStream), mExtensions (extensions),
-      mPutback (Putback_None), mPutbackCode(0), mPutbackInteger(0), mPutbackFloat(0),
+    : mErrorHandler (errorHandler),
+      mSource ((std::istreambuf_iterator<char> (inputStream)), std::istreambuf_iterator<char>()),
+      mPos (0), mLiteralStart (0), mEof (false), mPrevColumn (0), mPrevLine (0), mPrevLiteralStart (0),
+      mExtensions (extensions), mPutback (Putback_None), mPutbackCode(0), mPutbackInteger(0), mPutbackFloat(0),
       mStrictKeywords (false)
     {
     }
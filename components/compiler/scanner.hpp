@@ -1,6 +1,7 @@
 #ifndef COMPILER_SCANNER_H_INCLUDED
 #define COMPILER_SCANNER_H_INCLUDED
 
+#include <cstddef>
 #include <string>
 #include <iosfwd>
 #include <vector>
@@ -17,6 +18,9 @@ namespace Compiler
     ///
     /// This class translate a char-stream to a token stream (delivered via
     /// parser-callbacks).
+    ///
+    /// The stream is read completely when the scanner is constructed. Tokens are taken from that copy
+    /// without building them character by character.
 
     class Scanner
     {
@@ -27,9 +31,14 @@ namespace Compiler
             };
 
             ErrorHandler& mErrorHandler;
-            TokenLoc mLoc;
-            TokenLoc mPrevLoc;
-            std::istream& mStream;
+            TokenLoc mLoc; // mLiteral is only up to date after getTokenLoc
+            std::string mSource;
+            std::size_t mPos; // of the next character in mSource
+            std::size_t mLiteralStart; // of the current token in mSource
+            bool mEof; // reading past the end of mSource was attempted
+            int mPrevColumn; // before the last get
+            int mPrevLine;
+            std::size_t mPrevLiteralStart;
             const Extensions *mExtensions;
             putback_type mPutback;
             int mPutbackCode;
@@ -80,6 +89,13 @@ namespace Compiler
             bool get (char& c);
 
             void putback (char c);
+            ///< Undo the last get. \a c must be the character returned by it.
+
+            const TokenLoc& getTokenLoc();
+            ///< Location of the current token, with the characters read for it so far as literal.
+
+            void clearLiteral();
+            ///< Start a new token at the current position.
 
             bool scanToken (Parser& parser);
 
@@ -89,9 +105,6 @@ namespace Compiler
 
             bool scanName (char c, Parser& parser, bool& cont);
 
-            /// \param name May contain the start of the name (one or more characters)
-            bool scanName (std::string& name);
-
             bool scanSpecial (char c, Parser& parser, bool& cont);
 
             bool isStringCharacter (char c, bool lookAhead = true);
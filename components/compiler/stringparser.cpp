@@ -1,8 +1,5 @@
 #include "stringparser.hpp"
 
-#include <algorithm>
-#include <iterator>
-
 #include <components/misc/stringops.hpp>
 
 #include "scanner.hpp"
@@ -72,7 +69,7 @@ namespace Compiler
 
     void StringParser::append (std::vector<Interpreter::Type_Code>& code)
     {
-        std::copy (mCode.begin(), mCode.end(), std::back_inserter (code));
+        code.insert (code.end(), mCode.begin(), mCode.end());
     }
 
     void StringParser::reset()
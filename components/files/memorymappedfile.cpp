@@ -0,0 +1,196 @@
+#include "memorymappedfile.hpp"
+
+#include <stdexcept>
+#include <sstream>
+#include <cassert>
+
+#if FILE_API == FILE_API_POSIX
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+#elif FILE_API == FILE_API_WIN32
+#include <boost/locale.hpp>
+#endif
+
+namespace Files
+{
+
+#if FILE_API == FILE_API_STDIO
+/*
+ *
+ *  Memory mapping is not available with plain stdio
+ *
+ */
+
+MemoryMappedFile::MemoryMappedFile ()
+    : mData (NULL), mSize (0)
+{
+}
+
+MemoryMappedFile::~MemoryMappedFile ()
+{
+}
+
+void MemoryMappedFile::open (char const * filename)
+{
+    std::ostringstream os;
+    os << "Failed to map '" << filename << "': memory mapped files are not supported on this platform.";
+    throw std::runtime_error (os.str ());
+}
+
+void MemoryMappedFile::close ()
+{
+}
+
+#elif FILE_API == FILE_API_POSIX
+/*
+ *
+ *  Implementation of MemoryMappedFile methods using mmap
+ *
+ */
+
+MemoryMappedFile::MemoryMappedFile ()
+    : mData (NULL), mSize (0)
+{
+}
+
+MemoryMappedFile::~MemoryMappedFile ()
+{
+    if (mData != NULL)
+        close ();
+}
+
+void MemoryMappedFile::open (char const * filename)
+{
+    assert (mData == NULL);
+
+    int handle = ::open (filename, O_RDONLY);
+    if (handle == -1)
+    {
+        std::ostringstream os;
+        os << "Failed to open '" << filename << "' for reading: " << strerror(errno);
+        throw std::runtime_error (os.str ());
+    }
+
+    struct stat info;
+    if (::fstat (handle, &info) != 0 || info.st_size == 0)
+    {
+        ::close (handle);
+        std::ostringstream os;
+        os << "Failed to map '" << filename << "': unable to query file size or file is empty.";
+        throw std::runtime_error (os.str ());
+    }
+
+    size_t size = static_cast<size_t> (info.st_size);
+    void* data = ::mmap (NULL, size, PROT_READ, MAP_SHARED, handle, 0);
+
+    // the mapping stays valid after the file descriptor is closed
+    ::close (handle);
+
+    if (data == MAP_FAILED)
+    {
+        std::ostringstream os;
+        os << "Failed to map '" << filename << "': " << strerror(errno);
+        throw std::runtime_error (os.str ());
+    }
+
+    mData = static_cast<const char*> (data);
+    mSize = size;
+}
+
+void MemoryMappedFile::close ()
+{
+    assert (mData != NULL);
+
+    ::munmap (const_cast<char*> (mData), mSize);
+
+    mData = NULL;
+    mSize = 0;
+}
+
+#elif FILE_API == FILE_API_WIN32
+/*
+ *
+ *  Implementation of MemoryMappedFile methods using Win32 API calls
+ *
+ */
+
+MemoryMappedFile::MemoryMappedFile ()
+    : mData (NULL), mSize (0), mMapping (NULL)
+{
+}
+
+MemoryMappedFile::~MemoryMappedFile ()
+{
+    if (mData != NULL)
+        close ();
+}
+
+void MemoryMappedFile::open (char const * filename)
+{
+    assert (mData == NULL);
+
+    std::wstring wname = boost::locale::conv::utf_to_utf<wchar_t>(filename);
+    HANDLE handle = CreateFileW (wname.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, 0, 0);
+
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        std::ostringstream os;
+        os << "Failed to open '" << filename << "' for reading.";
+        throw std::runtime_error (os.str ());
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx (handle, &size) || size.QuadPart == 0)
+    {
+        CloseHandle (handle);
+        std::ostringstream os;
+        os << "Failed to map '" << filename << "': unable to query file size or file is empty.";
+        throw std::runtime_error (os.str ());
+    }
+
+    HANDLE mapping = CreateFileMappingW (handle, 0, PAGE_READONLY, 0, 0, 0);
+
+    // the mapping object keeps its own reference to the file
+    CloseHandle (handle);
+
+    if (mapping == NULL)
+    {
+        std::ostringstream os;
+        os << "Failed to map '" << filename << "'.";
+        throw std::runtime_error (os.str ());
+    }
+
+    LPVOID data = MapViewOfFile (mapping, FILE_MAP_READ, 0, 0, 0);
+    if (data == NULL)
+    {
+        CloseHandle (mapping);
+        std::ostringstream os;
+        os << "Failed to map '" << filename << "'.";
+        throw std::runtime_error (os.str ());
+    }
+
+    mMapping = mapping;
+    mData = static_cast<const char*> (data);
+    mSize = static_cast<size_t> (size.QuadPart);
+}
+
+void MemoryMappedFile::close ()
+{
+    assert (mData != NULL);
+
+    UnmapViewOfFile (mData);
+    CloseHandle (mMapping);
+
+    mData = NULL;
+    mSize = 0;
+    mMapping = NULL;
+}
+
+#endif
+
+}
@@ -0,0 +1,42 @@
+#ifndef COMPONENTS_FILES_MEMORYMAPPEDFILE_HPP
+#define COMPONENTS_FILES_MEMORYMAPPEDFILE_HPP
+
+#include <cstdlib>
+
+#include "lowlevelfile.hpp"
+
+namespace Files
+{
+
+/// @brief A read-only view of a complete file mapped into memory.
+/// @note Only supported with the POSIX and Win32 file APIs, open() throws an exception otherwise.
+class MemoryMappedFile
+{
+public:
+
+    MemoryMappedFile ();
+    ~MemoryMappedFile ();
+
+    /// Map the given file. Throws an exception on failure.
+    void open (char const * filename);
+    void close ();
+
+    bool isOpen () const { return mData != NULL; }
+
+    const char* data () const { return mData; }
+    size_t size () const { return mSize; }
+
+private:
+    MemoryMappedFile (const MemoryMappedFile&);
+    void operator = (const MemoryMappedFile&);
+
+    const char* mData;
+    size_t mSize;
+#if FILE_API == FILE_API_WIN32
+    HANDLE mMapping;
+#endif
+};
+
+}
+
+#endif
@@ -14,6 +14,30 @@ namespace Files
             char* nonconstBuffer = (const_cast<char*>(buffer));
             this->setg(nonconstBuffer, nonconstBuffer, nonconstBuffer + size);
         }
+
+    protected:
+        virtual pos_type seekoff(off_type offset, std::ios_base::seekdir dir, std::ios_base::openmode mode)
+        {
+            if (!(mode & std::ios_base::in))
+                return pos_type(off_type(-1));
+
+            char* base = eback();
+            if (dir == std::ios_base::cur)
+                base = gptr();
+            else if (dir == std::ios_base::end)
+                base = egptr();
+
+            if (offset < eback() - base || offset > egptr() - base)
+                return pos_type(off_type(-1));
+
+            this->setg(eback(), base + offset, egptr());
+            return pos_type(gptr() - eback());
+        }
+
+        virtual pos_type seekpos(pos_type pos, std::ios_base::openmode mode)
+        {
+            return seekoff(off_type(pos), std::ios_base::beg, mode);
+        }
     };
 
     /// @brief A variant of std::istream that reads from a constant in-memory buffer.
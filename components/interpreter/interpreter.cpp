@@ -8,57 +8,50 @@
 
 namespace Interpreter
 {
-    void Interpreter::execute (Type_Code code)
+    void Interpreter::decode (Type_Code code, Program::Instruction& instruction) const
     {
+        instruction.mArguments = -1;
+        instruction.mCode = code;
+        instruction.mArg0 = 0;
+        instruction.mArg1 = 0;
+
         unsigned int segSpec = code>>30;
 
         switch (segSpec)
         {
             case 0:
-            {
-                int opcode = code>>24;
-                unsigned int arg0 = code & 0xffffff;
-
-                std::map<int, Opcode1 *>::iterator iter = mSegment0.find (opcode);
 
-                if (iter==mSegment0.end())
-                    abortUnknownCode (0, opcode);
-
-                iter->second->execute (mRuntime, arg0);
+                if (Opcode1 *opcode = mSegment0.find (code>>24))
+                {
+                    instruction.mArguments = 1;
+                    instruction.mOpcode1 = opcode;
+                    instruction.mArg0 = code & 0xffffff;
+                }
 
                 return;
-            }
 
             case 1:
-            {
-                int opcode = (code>>24) & 0x3f;
-                unsigned int arg0 = (code>>16) & 0xfff;
-                unsigned int arg1 = code & 0xfff;
 
-                std::map<int, Opcode2 *>::iterator iter = mSegment1.find (opcode);
-
-                if (iter==mSegment1.end())
-                    abortUnknownCode (1, opcode);
-
-                iter->second->execute (mRuntime, arg0, arg1);
+                if (Opcode2 *opcode = mSegment1.find ((code>>24) & 0x3f))
+                {
+                    instruction.mArguments = 2;
+                    instruction.mOpcode2 = opcode;
+                    instruction.mArg0 = (code>>16) & 0xfff;
+                    instruction.mArg1 = code & 0xfff;
+                }
 
                 return;
-            }
 
             case 2:
-            {
-                int opcode = (code>>20) & 0x3ff;
-                unsigned int arg0 = code & 0xfffff;
-
-                std::map<int, Opcode1 *>::iterator iter = mSegment2.find (opcode);
-
-                if (iter==mSegment2.end())
-                    abortUnknownCode (2, opcode);
 
-                iter->second->execute (mRuntime, arg0);
+                if (Opcode1 *opcode = mSegment2.find ((code>>20) & 0x3ff))
+                {
+                    instruction.mArguments = 1;
+                    instruction.mOpcode1 = opcode;
+                    instruction.mArg0 = code & 0xfffff;
+                }
 
                 return;
-            }
         }
 
         segSpec = code>>26;
@@ -66,55 +59,83 @@ namespace Interpreter
         switch (segSpec)
         {
             case 0x30:
-            {
-                int opcode = (code>>8) & 0x3ffff;
-                unsigned int arg0 = code & 0xff;
-
-                std::map<int, Opcode1 *>::iterator iter = mSegment3.find (opcode);
 
-                if (iter==mSegment3.end())
-                    abortUnknownCode (3, opcode);
-
-                iter->second->execute (mRuntime, arg0);
+                if (Opcode1 *opcode = mSegment3.find ((code>>8) & 0x3ffff))
+                {
+                    instruction.mArguments = 1;
+                    instruction.mOpcode1 = opcode;
+                    instruction.mArg0 = code & 0xff;
+                }
 
                 return;
-            }
 
             case 0x31:
-            {
-                int opcode = (code>>16) & 0x3ff;
-                unsigned int arg0 = (code>>8) & 0xff;
-                unsigned int arg1 = code & 0xff;
 
-                std::map<int, Opcode2 *>::iterator iter = mSegment4.find (opcode);
+                if (Opcode2 *opcode = mSegment4.find ((code>>16) & 0x3ff))
+                {
+                    instruction.mArguments = 2;
+                    instruction.mOpcode2 = opcode;
+                    instruction.mArg0 = (code>>8) & 0xff;
+                    instruction.mArg1 = code & 0xff;
+                }
 
-                if (iter==mSegment4.end())
-                    abortUnknownCode (4, opcode);
+                return;
+
+            case 0x32:
 
-                iter->second->execute (mRuntime, arg0, arg1);
+                if (Opcode0 *opcode = mSegment5.find (code & 0x3ffffff))
+                {
+                    instruction.mArguments = 0;
+                    instruction.mOpcode0 = opcode;
+                }
 
                 return;
-            }
+        }
+    }
 
-            case 0x32:
-            {
-                int opcode = code & 0x3ffffff;
+    void Interpreter::execute (const Program::Instruction& instruction, Runtime& runtime) const
+    {
+        switch (instruction.mArguments)
+        {
+            case 0: instruction.mOpcode0->execute (runtime); return;
+            case 1: instruction.mOpcode1->execute (runtime, instruction.mArg0); return;
+            case 2: instruction.mOpcode2->execute (runtime, instruction.mArg0, instruction.mArg1); return;
+        }
 
-                std::map<int, Opcode0 *>::iterator iter = mSegment5.find (opcode);
+        abortUnknown (instruction.mCode);
+    }
 
-                if (iter==mSegment5.end())
-                    abortUnknownCode (5, opcode);
+    void Interpreter::execute (Type_Code code)
+    {
+        Program::Instruction instruction;
+        decode (code, instruction);
+        execute (instruction, mRuntime);
+    }
 
-                iter->second->execute (mRuntime);
+    void Interpreter::abortUnknown (Type_Code code) const
+    {
+        unsigned int segSpec = code>>30;
 
-                return;
-            }
-        }
+        if (segSpec==0)
+            abortUnknownCode (0, code>>24);
+        else if (segSpec==1)
+            abortUnknownCode (1, (code>>24) & 0x3f);
+        else if (segSpec==2)
+            abortUnknownCode (2, (code>>20) & 0x3ff);
+
+        segSpec = code>>26;
+
+        if (segSpec==0x30)
+            abortUnknownCode (3, (code>>8) & 0x3ffff);
+        else if (segSpec==0x31)
+            abortUnknownCode (4, (code>>16) & 0x3ff);
+        else if (segSpec==0x32)
+            abortUnknownCode (5, code & 0x3ffffff);
 
         abortUnknownSegment (code);
     }
 
-    void Interpreter::abortUnknownCode (int segment, int opcode)
+    void Interpreter::abortUnknownCode (int segment, int opcode) const
     {
         std::ostringstream error;
 
@@ -123,7 +144,7 @@ namespace Interpreter
         throw std::runtime_error (error.str());
     }
 
-    void Interpreter::abortUnknownSegment (Type_Code code)
+    void Interpreter::abortUnknownSegment (Type_Code code) const
     {
         std::ostringstream error;
 
@@ -163,66 +184,48 @@ namespace Interpreter
     {}
 
     Interpreter::~Interpreter()
-    {
-        for (std::map<int, Opcode1 *>::iterator iter (mSegment0.begin());
-            iter!=mSegment0.end(); ++iter)
-            delete iter->second;
-
-        for (std::map<int, Opcode2 *>::iterator iter (mSegment1.begin());
-            iter!=mSegment1.end(); ++iter)
-            delete iter->second;
-
-        for (std::map<int, Opcode1 *>::iterator iter (mSegment2.begin());
-            iter!=mSegment2.end(); ++iter)
-            delete iter->second;
-
-        for (std::map<int, Opcode1 *>::iterator iter (mSegment3.begin());
-            iter!=mSegment3.end(); ++iter)
-            delete iter->second;
-
-        for (std::map<int, Opcode2 *>::iterator iter (mSegment4.begin());
-            iter!=mSegment4.end(); ++iter)
-            delete iter->second;
-
-        for (std::map<int, Opcode0 *>::iterator iter (mSegment5.begin());
-            iter!=mSegment5.end(); ++iter)
-            delete iter->second;
-    }
+    {}
 
     void Interpreter::installSegment0 (int code, Opcode1 *opcode)
     {
-        assert(mSegment0.find(code) == mSegment0.end());
-        mSegment0.insert (std::make_pair (code, opcode));
+        bool inserted = mSegment0.insert (code, opcode);
+        assert (inserted);
+        (void)inserted;
     }
 
     void Interpreter::installSegment1 (int code, Opcode2 *opcode)
     {
-        assert(mSegment1.find(code) == mSegment1.end());
-        mSegment1.insert (std::make_pair (code, opcode));
+        bool inserted = mSegment1.insert (code, opcode);
+        assert (inserted);
+        (void)inserted;
     }
 
     void Interpreter::installSegment2 (int code, Opcode1 *opcode)
     {
-        assert(mSegment2.find(code) == mSegment2.end());
-        mSegment2.insert (std::make_pair (code, opcode));
+        bool inserted = mSegment2.insert (code, opcode);
+        assert (inserted);
+        (void)inserted;
     }
 
     void Interpreter::installSegment3 (int code, Opcode1 *opcode)
     {
-        assert(mSegment3.find(code) == mSegment3.end());
-        mSegment3.insert (std::make_pair (code, opcode));
+        bool inserted = mSegment3.insert (code, opcode);
+        assert (inserted);
+        (void)inserted;
     }
 
     void Interpreter::installSegment4 (int code, Opcode2 *opcode)
     {
-        assert(mSegment4.find(code) == mSegment4.end());
-        mSegment4.insert (std::make_pair (code, opcode));
+        bool inserted = mSegment4.insert (code, opcode);
+        assert (inserted);
+        (void)inserted;
     }
 
     void Interpreter::installSegment5 (int code, Opcode0 *opcode)
     {
-        assert(mSegment5.find(code) == mSegment5.end());
-        mSegment5.insert (std::make_pair (code, opcode));
+        bool inserted = mSegment5.insert (code, opcode);
+        assert (inserted);
+        (void)inserted;
     }
 
     void Interpreter::run (const Type_Code *code, int codeSize, Context& context)
@@ -254,4 +257,80 @@ namespace Interpreter
 
         end();
     }
+
+    void Interpreter::prepare (const Type_Code *code, int codeSize, Program& program) const
+    {
+        assert (codeSize>=4);
+
+        int opcodes = static_cast<int> (code[0]);
+
+        const Type_Code *codeBlock = code + 4;
+
+        program.mInstructions.resize (opcodes);
+
+        for (int i=0; i<opcodes; ++i)
+            decode (codeBlock[i], program.mInstructions[i]);
+    }
+
+    unsigned int Interpreter::run (const Type_Code *code, int codeSize, const Program& program, Context& context)
+    {
+        assert (codeSize>=4);
+        assert (program.mInstructions.size()==static_cast<std::size_t> (code[0]));
+
+        begin();
+
+        unsigned int executed = 0;
+
+        try
+        {
+            mRuntime.configure (code, codeSize, context);
+
+            int opcodes = static_cast<int> (program.mInstructions.size());
+
+            const Program::Instruction *instructions = program.mInstructions.empty() ? 0 : &program.mInstructions[0];
+
+            while (mRuntime.getPC()>=0 && mRuntime.getPC()<opcodes)
+            {
+                const Program::Instruction& instruction = instructions[mRuntime.getPC()];
+                mRuntime.setPC (mRuntime.getPC()+1);
+                execute (instruction, mRuntime);
+                ++executed;
+            }
+        }
+        catch (...)
+        {
+            end();
+            throw;
+        }
+
+        end();
+
+        return executed;
+    }
+
+    unsigned int Interpreter::runDetached (const Type_Code *code, int codeSize, const Program& program,
+        Context& context) const
+    {
+        assert (codeSize>=4);
+        assert (program.mInstructions.size()==static_cast<std::size_t> (code[0]));
+
+        Runtime runtime;
+        runtime.configure (code, codeSize, context);
+
+        int opcodes = static_cast<int> (program.mInstructions.size());
+
+        const Program::Instruction *instructions = program.mInstructions.empty() ? 0 : &program.mInstructions[0];
+
+        unsigned int executed = 0;
+
+        while (runtime.getPC()>=0 && runtime.getPC()<opcodes)
+        {
+            const Program::Instruction& instruction = instructions[runtime.getPC()];
+            runtime.setPC (runtime.getPC()+1);
+            execute (instruction, runtime);
+            ++executed;
+        }
+
+        return executed;
+    }
 }
@@ -1,9 +1,10 @@
 #ifndef INTERPRETER_INTERPRETER_H_INCLUDED
 #define INTERPRETER_INTERPRETER_H_INCLUDED
 
-#include <map>
 #include <stack>
+#include <vector>
 
+#include "opcodetable.hpp"
 #include "runtime.hpp"
 #include "types.hpp"
 
@@ -13,27 +14,65 @@ namespace Interpreter
     class Opcode1;
     class Opcode2;
 
+    /// \brief Script code with every instruction already decoded and resolved to its opcode handler.
+    ///
+    /// Only valid for the Interpreter that prepared it, as long as no further opcodes are installed.
+    class Program
+    {
+            friend class Interpreter;
+
+            struct Instruction
+            {
+                int mArguments; // -1 for codes that could not be resolved
+                union
+                {
+                    Opcode0 *mOpcode0;
+                    Opcode1 *mOpcode1;
+                    Opcode2 *mOpcode2;
+                    Type_Code mCode;
+                };
+                unsigned int mArg0;
+                unsigned int mArg1;
+            };
+
+            std::vector<Instruction> mInstructions;
+
+        public:
+
+            bool empty() const { return mInstructions.empty(); }
+
+            void clear() { mInstructions.clear(); }
+    };
+
     class Interpreter
     {
             std::stack<Runtime> mCallstack;
             bool mRunning;
             Runtime mRuntime;
-            std::map<int, Opcode1 *> mSegment0;
-            std::map<int, Opcode2 *> mSegment1;
-            std::map<int, Opcode1 *> mSegment2;
-            std::map<int, Opcode1 *> mSegment3;
-            std::map<int, Opcode2 *> mSegment4;
-            std::map<int, Opcode0 *> mSegment5;
+            OpcodeTable<Opcode1> mSegment0;
+            OpcodeTable<Opcode2> mSegment1;
+            OpcodeTable<Opcode1> mSegment2;
+            OpcodeTable<Opcode1> mSegment3;
+            OpcodeTable<Opcode2> mSegment4;
+            OpcodeTable<Opcode0> mSegment5;
 
             // not implemented
             Interpreter (const Interpreter&);
             Interpreter& operator= (const Interpreter&);
 
+            void decode (Type_Code code, Program::Instruction& instruction) const;
+            ///< Leaves mArguments at -1 for unknown codes.
+
+            void execute (const Program::Instruction& instruction, Runtime& runtime) const;
+
             void execute (Type_Code code);
 
-            void abortUnknownCode (int segment, int opcode);
+            void abortUnknown (Type_Code code) const;
+            ///< Report \a code as an unknown opcode or segment.
+
+            void abortUnknownCode (int segment, int opcode) const;
 
-            void abortUnknownSegment (Type_Code code);
+            void abortUnknownSegment (Type_Code code) const;
 
             void begin();
 
@@ -64,6 +103,20 @@ namespace Interpreter
             ///< ownership of \a opcode is transferred to *this.
 
             void run (const Type_Code *code, int codeSize, Context& context);
+
+            void prepare (const Type_Code *code, int codeSize, Program& program) const;
+            ///< Decode \a code once, to run it repeatedly without looking up every opcode.
+            /// Unknown opcodes are only reported when they are executed.
+
+            unsigned int run (const Type_Code *code, int codeSize, const Program& program, Context& context);
+            ///< Run \a code that was prepared by this interpreter into \a program.
+            /// \return Number of instructions executed (not counting scripts run from within).
+
+            unsigned int runDetached (const Type_Code *code, int codeSize, const Program& program,
+                Context& context) const;
+            ///< Run \a code like run, but with a runtime of its own, so that several threads can run code at the
+            /// same time. Only for code that doesn't start other scripts and only uses opcodes without state.
+            /// \return Number of instructions executed.
     };
 }
 
@@ -0,0 +1,105 @@
+#ifndef INTERPRETER_OPCODETABLE_H_INCLUDED
+#define INTERPRETER_OPCODETABLE_H_INCLUDED
+
+#include <cstddef>
+#include <vector>
+
+namespace Interpreter
+{
+    /// \brief Handlers of one opcode segment, indexed by opcode.
+    ///
+    /// The opcodes of a segment are sparse overall (extensions start far above the built-in codes), but
+    /// dense within each range. Each range is stored as a contiguous block, so a lookup only has to find the
+    /// block (there are very few) and index into it.
+    ///
+    /// Owns the installed handlers.
+    template<typename T>
+    class OpcodeTable
+    {
+            struct Block
+            {
+                int mFirst;
+                std::vector<T *> mOpcodes;
+            };
+
+            std::vector<Block> mBlocks; // sorted by mFirst, not overlapping
+
+            // Codes at most this far away from a block are added to it rather than starting a new block
+            static const int sMaxGap = 256;
+
+            // not implemented
+            OpcodeTable (const OpcodeTable&);
+            OpcodeTable& operator= (const OpcodeTable&);
+
+        public:
+
+            OpcodeTable() {}
+
+            ~OpcodeTable()
+            {
+                for (typename std::vector<Block>::iterator block (mBlocks.begin()); block!=mBlocks.end(); ++block)
+                    for (typename std::vector<T *>::iterator iter (block->mOpcodes.begin()); iter!=block->mOpcodes.end(); ++iter)
+                        delete *iter;
+            }
+
+            T *find (int code) const
+            {
+                for (typename std::vector<Block>::const_iterator block (mBlocks.begin()); block!=mBlocks.end(); ++block)
+                {
+                    if (code<block->mFirst)
+                        return 0;
+
+                    std::size_t index = static_cast<std::size_t> (code - block->mFirst);
+                    if (index<block->mOpcodes.size())
+                        return block->mOpcodes[index];
+                }
+
+                return 0;
+            }
+
+            /// \return false, if an opcode is already installed for \a code (ownership of \a opcode is
+            /// transferred to *this only if true is returned).
+            bool insert (int code, T *opcode)
+            {
+                if (find (code))
+                    return false;
+
+                typename std::vector<Block>::iterator block (mBlocks.begin());
+                while (block!=mBlocks.end() &&
+                    block->mFirst + static_cast<int> (block->mOpcodes.size()) + sMaxGap < code)
+                    ++block;
+
+                if (block==mBlocks.end() || code + sMaxGap < block->mFirst)
+                {
+                    Block newBlock;
+                    newBlock.mFirst = code;
+                    block = mBlocks.insert (block, newBlock);
+                }
+                else if (code<block->mFirst)
+                {
+                    block->mOpcodes.insert (block->mOpcodes.begin(), block->mFirst - code, static_cast<T *> (0));
+                    block->mFirst = code;
+                }
+
+                std::size_t index = static_cast<std::size_t> (code - block->mFirst);
+                if (index>=block->mOpcodes.size())
+                    block->mOpcodes.resize (index+1, 0);
+
+                block->mOpcodes[index] = opcode;
+
+                // Growing the block may have closed the gap to the next one
+                typename std::vector<Block>::iterator next = block + 1;
+                if (next!=mBlocks.end() &&
+                    next->mFirst <= block->mFirst + static_cast<int> (block->mOpcodes.size()) + sMaxGap)
+                {
+                    block->mOpcodes.resize (next->mFirst - block->mFirst, 0);
+                    block->mOpcodes.insert (block->mOpcodes.end(), next->mOpcodes.begin(), next->mOpcodes.end());
+                    mBlocks.erase (next);
+                }
+
+                return true;
+            }
+    };
+}
+
+#endif
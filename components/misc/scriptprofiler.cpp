@@ -0,0 +1,162 @@
+#include "scriptprofiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+namespace
+{
+    bool compareSelfTime (const std::pair<std::string, Misc::ScriptProfiler::Stats>& left,
+        const std::pair<std::string, Misc::ScriptProfiler::Stats>& right)
+    {
+        return left.second.mSelfTime > right.second.mSelfTime;
+    }
+}
+
+namespace Misc
+{
+    ScriptProfiler::Scope::Scope (ScriptProfiler& profiler, const std::string& id)
+    : mProfiler (profiler.isEnabled() ? &profiler : 0)
+    {
+        if (mProfiler)
+            mProfiler->enter (id);
+    }
+
+    ScriptProfiler::Scope::Scope (ScriptProfiler& profiler, const char *id)
+    : mProfiler (profiler.isEnabled() ? &profiler : 0)
+    {
+        if (mProfiler)
+            mProfiler->enter (id);
+    }
+
+    ScriptProfiler::Scope::~Scope()
+    {
+        if (mProfiler)
+            mProfiler->leave();
+    }
+
+    ScriptProfiler::ScriptProfiler() : mEnabled (false), mInstructions (0) {}
+
+    void ScriptProfiler::setEnabled (bool enabled)
+    {
+        mEnabled = enabled;
+    }
+
+    bool ScriptProfiler::isEnabled() const
+    {
+        return mEnabled;
+    }
+
+    void ScriptProfiler::enter (const std::string& id)
+    {
+        Frame frame;
+        frame.mId = id;
+
+        // ';' separates the calls of a stack in the folded format
+        std::replace (frame.mId.begin(), frame.mId.end(), ';', ':');
+
+        frame.mStack = mFrames.empty() ? frame.mId : mFrames.back().mStack + ";" + frame.mId;
+        frame.mChildTime = 0;
+        frame.mInstructionsAtStart = mInstructions;
+        frame.mChildInstructions = 0;
+
+        mFrames.push_back (frame);
+
+        // Start last, so the bookkeeping above is not measured
+        mFrames.back().mStart = Clock::now();
+    }
+
+    void ScriptProfiler::leave()
+    {
+        if (mFrames.empty())
+            return;
+
+        const Frame& frame = mFrames.back();
+
+        double totalTime = std::chrono::duration<double> (Clock::now() - frame.mStart).count();
+        double selfTime = std::max (0.0, totalTime - frame.mChildTime);
+        unsigned long long totalInstructions = mInstructions - frame.mInstructionsAtStart;
+        unsigned long long selfInstructions = totalInstructions - frame.mChildInstructions;
+
+        bool recursive = false;
+        for (std::vector<Frame>::const_iterator iter (mFrames.begin()); iter+1!=mFrames.end(); ++iter)
+            if (iter->mId==frame.mId)
+            {
+                recursive = true;
+                break;
+            }
+
+        Stats& script = mScripts[frame.mId];
+        ++script.mCalls;
+        if (!recursive)
+            script.mTotalTime += totalTime;
+        script.mSelfTime += selfTime;
+        script.mInstructions += selfInstructions;
+
+        Stats& stack = mStacks[frame.mStack];
+        ++stack.mCalls;
+        stack.mTotalTime += totalTime;
+        stack.mSelfTime += selfTime;
+        stack.mInstructions += selfInstructions;
+
+        mFrames.pop_back();
+
+        if (!mFrames.empty())
+        {
+            mFrames.back().mChildTime += totalTime;
+            mFrames.back().mChildInstructions += totalInstructions;
+        }
+    }
+
+    void ScriptProfiler::addInstructions (unsigned long long instructions)
+    {
+        mInstructions += instructions;
+    }
+
+    void ScriptProfiler::clear()
+    {
+        mScripts.clear();
+        mStacks.clear();
+    }
+
+    const std::map<std::string, ScriptProfiler::Stats>& ScriptProfiler::getScripts() const
+    {
+        return mScripts;
+    }
+
+    void ScriptProfiler::writeFolded (std::ostream& stream) const
+    {
+        for (std::map<std::string, Stats>::const_iterator iter (mStacks.begin()); iter!=mStacks.end(); ++iter)
+        {
+            long long microseconds = static_cast<long long> (std::floor (iter->second.mSelfTime * 1e6 + 0.5));
+
+            if (microseconds>0)
+                stream << iter->first << ' ' << microseconds << '\n';
+        }
+    }
+
+    void ScriptProfiler::writeSummary (std::ostream& stream, std::size_t maxEntries) const
+    {
+        std::vector<std::pair<std::string, Stats> > scripts (mScripts.begin(), mScripts.end());
+
+        std::size_t count = std::min (maxEntries, scripts.size());
+
+        std::partial_sort (scripts.begin(), scripts.begin()+count, scripts.end(), compareSelfTime);
+
+        std::ios_base::fmtflags flags = stream.flags();
+        std::streamsize precision = stream.precision();
+
+        for (std::size_t i=0; i<count; ++i)
+        {
+            const Stats& stats = scripts[i].second;
+
+            stream << scripts[i].first << ": " << stats.mCalls << " calls, "
+                << std::fixed << std::setprecision (3) << stats.mSelfTime * 1000 << " ms self, "
+                << stats.mTotalTime * 1000 << " ms total, "
+                << stats.mInstructions << " instructions\n";
+        }
+
+        stream.flags (flags);
+        stream.precision (precision);
+    }
+}
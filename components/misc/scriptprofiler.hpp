@@ -0,0 +1,101 @@
+#ifndef MISC_SCRIPTPROFILER_H
+#define MISC_SCRIPTPROFILER_H
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Misc
+{
+    /// \brief Measures the time taken by scripts, per script and per call stack.
+    ///
+    /// A call lasts from enter to the matching leave; calls made in between are nested in it. The self time
+    /// and self instructions of a call don't include those of its nested calls. Not thread-safe.
+    class ScriptProfiler
+    {
+        public:
+
+            struct Stats
+            {
+                unsigned long long mCalls;
+                double mTotalTime; // in seconds
+                double mSelfTime; // in seconds
+                unsigned long long mInstructions; // self
+
+                Stats() : mCalls (0), mTotalTime (0), mSelfTime (0), mInstructions (0) {}
+            };
+
+            /// \brief Records a call for the lifetime of the object.
+            ///
+            /// Nothing is recorded, if the profiler is disabled when the object is created.
+            class Scope
+            {
+                    ScriptProfiler *mProfiler;
+
+                    // not implemented
+                    Scope (const Scope&);
+                    Scope& operator= (const Scope&);
+
+                public:
+
+                    Scope (ScriptProfiler& profiler, const std::string& id);
+
+                    Scope (ScriptProfiler& profiler, const char *id);
+                    ///< \a id is only converted to a string if the profiler is enabled.
+
+                    ~Scope();
+            };
+
+            ScriptProfiler();
+
+            void setEnabled (bool enabled);
+            ///< Calls that are in progress are still recorded when they end.
+
+            bool isEnabled() const;
+
+            void enter (const std::string& id);
+
+            void leave();
+
+            void addInstructions (unsigned long long instructions);
+            ///< Count \a instructions as executed by the innermost call.
+
+            void clear();
+            ///< Discard all results.
+
+            const std::map<std::string, Stats>& getScripts() const;
+            ///< Results by script ID. Time spent in recursive calls only counts once towards the total time.
+
+            void writeFolded (std::ostream& stream) const;
+            ///< Write the self time of each call stack in microseconds, in the folded format that flame graph
+            /// tools read ("outer;inner 123", one stack per line).
+
+            void writeSummary (std::ostream& stream, std::size_t maxEntries) const;
+            ///< Write the results of the \a maxEntries scripts with the highest self time, one per line.
+
+        private:
+
+            typedef std::chrono::steady_clock Clock;
+
+            struct Frame
+            {
+                std::string mId;
+                std::string mStack;
+                Clock::time_point mStart;
+                double mChildTime;
+                unsigned long long mInstructionsAtStart;
+                unsigned long long mChildInstructions;
+            };
+
+            bool mEnabled;
+            unsigned long long mInstructions; // executed since construction
+            std::vector<Frame> mFrames; // calls in progress, innermost last
+            std::map<std::string, Stats> mScripts; // by ID
+            std::map<std::string, Stats> mStacks; // by IDs of the call stack, separated by ';'
+    };
+}
+
+#endif
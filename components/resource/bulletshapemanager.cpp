@@ -112,8 +112,8 @@ BulletShapeManager::~BulletShapeManager()
 
 osg::ref_ptr<const BulletShape> BulletShapeManager::getShape(const std::string &name)
 {
-    std::string normalized = name;
-    mVFS->normalizeFilename(normalized);
+    std::string normalizedBuffer;
+    const std::string& normalized = mVFS->normalizeFilename(name, normalizedBuffer);
 
     osg::ref_ptr<BulletShape> shape;
     osg::ref_ptr<osg::Object> obj = mCache->getRefFromObjectCache(normalized);
@@ -154,8 +154,8 @@ osg::ref_ptr<const BulletShape> BulletShapeManager::getShape(const std::string &
 
 osg::ref_ptr<BulletShapeInstance> BulletShapeManager::cacheInstance(const std::string &name)
 {
-    std::string normalized = name;
-    mVFS->normalizeFilename(normalized);
+    std::string normalizedBuffer;
+    const std::string& normalized = mVFS->normalizeFilename(name, normalizedBuffer);
 
     osg::ref_ptr<BulletShapeInstance> instance = createInstance(normalized);
     mInstanceCache->addEntryToObjectCache(normalized, instance.get());
@@ -164,8 +164,8 @@ osg::ref_ptr<BulletShapeInstance> BulletShapeManager::cacheInstance(const std::s
 
 osg::ref_ptr<BulletShapeInstance> BulletShapeManager::getInstance(const std::string &name)
 {
-    std::string normalized = name;
-    mVFS->normalizeFilename(normalized);
+    std::string normalizedBuffer;
+    const std::string& normalized = mVFS->normalizeFilename(name, normalizedBuffer);
 
     osg::ref_ptr<osg::Object> obj = mInstanceCache->takeFromObjectCache(normalized);
     if (obj.get())
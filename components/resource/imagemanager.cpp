@@ -83,8 +83,8 @@ namespace Resource
 
     osg::ref_ptr<osg::Image> ImageManager::getImage(const std::string &filename)
     {
-        std::string normalized = filename;
-        mVFS->normalizeFilename(normalized);
+        std::string normalizedBuffer;
+        const std::string& normalized = mVFS->normalizeFilename(filename, normalizedBuffer);
 
         osg::ref_ptr<osg::Object> obj = mCache->getRefFromObjectCache(normalized);
         if (obj)
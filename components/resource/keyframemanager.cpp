@@ -18,8 +18,8 @@ namespace Resource
 
     osg::ref_ptr<const NifOsg::KeyframeHolder> KeyframeManager::get(const std::string &name)
     {
-        std::string normalized = name;
-        mVFS->normalizeFilename(normalized);
+        std::string normalizedBuffer;
+        const std::string& normalized = mVFS->normalizeFilename(name, normalizedBuffer);
 
         osg::ref_ptr<osg::Object> obj = mCache->getRefFromObjectCache(normalized);
         if (obj)
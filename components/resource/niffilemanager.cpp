@@ -43,13 +43,20 @@ namespace Resource
 
 
     Nif::NIFFilePtr NifFileManager::get(const std::string &name)
+    {
+        return get(name, Files::IStreamPtr());
+    }
+
+    Nif::NIFFilePtr NifFileManager::get(const std::string &name, Files::IStreamPtr stream)
     {
         osg::ref_ptr<osg::Object> obj = mCache->getRefFromObjectCache(name);
         if (obj)
             return static_cast<NifFileHolder*>(obj.get())->mNifFile;
         else
         {
-            Nif::NIFFilePtr file (new Nif::NIFFile(mVFS->get(name), name));
+            if (!stream)
+                stream = mVFS->get(name);
+            Nif::NIFFilePtr file (new Nif::NIFFile(stream, name));
             obj = new NifFileHolder(file);
             mCache->addEntryToObjectCache(name, obj);
             return file;
@@ -23,6 +23,10 @@ namespace Resource
         /// to be done in advance by other managers accessing the NifFileManager.
         Nif::NIFFilePtr get(const std::string& name);
 
+        /// Retrieve a NIF file from the cache, or load it from \a stream if not cached yet.
+        /// @param stream The contents of \a name, for callers that already opened the file.
+        Nif::NIFFilePtr get(const std::string& name, Files::IStreamPtr stream);
+
         void reportStats(unsigned int frameNumber, osg::Stats *stats) const;
     };
 
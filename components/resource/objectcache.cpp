@@ -13,6 +13,10 @@
 
 #include "objectcache.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 #include <osg/Object>
 #include <osg/Node>
 
@@ -24,7 +28,10 @@ namespace Resource
 // ObjectCache
 //
 ObjectCache::ObjectCache():
-    osg::Referenced(true)
+    osg::Referenced(true),
+    _fullUpdatePeriod(0.0),
+    _lastUpdateTime(-std::numeric_limits<double>::max()),
+    _nextShardToUpdate(0)
 {
 }
 
@@ -32,17 +39,24 @@ ObjectCache::~ObjectCache()
 {
 }
 
+ObjectCache::Shard& ObjectCache::getShard(const std::string& fileName)
+{
+    return _shards[std::hash<std::string>()(fileName) % NumShards];
+}
+
 void ObjectCache::addEntryToObjectCache(const std::string& filename, osg::Object* object, double timestamp)
 {
-    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
-    _objectCache[filename]=ObjectTimeStampPair(object,timestamp);
+    Shard& shard = getShard(filename);
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(shard._mutex);
+    shard._objectCache[filename]=ObjectTimeStampPair(object,timestamp);
 }
 
 osg::ref_ptr<osg::Object> ObjectCache::getRefFromObjectCache(const std::string& fileName)
 {
-    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
-    ObjectCacheMap::iterator itr = _objectCache.find(fileName);
-    if (itr!=_objectCache.end())
+    Shard& shard = getShard(fileName);
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(shard._mutex);
+    ObjectCacheMap::iterator itr = shard._objectCache.find(fileName);
+    if (itr!=shard._objectCache.end())
     {
         return itr->second.first;
     }
@@ -51,9 +65,10 @@ osg::ref_ptr<osg::Object> ObjectCache::getRefFromObjectCache(const std::string&
 
 bool ObjectCache::checkInObjectCache(const std::string &fileName, double timeStamp)
 {
-    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
-    ObjectCacheMap::iterator itr = _objectCache.find(fileName);
-    if (itr!=_objectCache.end())
+    Shard& shard = getShard(fileName);
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(shard._mutex);
+    ObjectCacheMap::iterator itr = shard._objectCache.find(fileName);
+    if (itr!=shard._objectCache.end())
     {
         itr->second.second = timeStamp;
         return true;
@@ -63,18 +78,22 @@ bool ObjectCache::checkInObjectCache(const std::string &fileName, double timeSta
 
 void ObjectCache::updateTimeStampOfObjectsInCacheWithExternalReferences(double referenceTime)
 {
-    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
-
-    // look for objects with external references and update their time stamp.
-    for(ObjectCacheMap::iterator itr=_objectCache.begin();
-        itr!=_objectCache.end();
-        ++itr)
+    for (unsigned int i=0; i<NumShards; ++i)
     {
-        // if ref count is greater the 1 the object has an external reference.
-        if (itr->second.first->referenceCount()>1)
+        Shard& shard = _shards[i];
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(shard._mutex);
+
+        // look for objects with external references and update their time stamp.
+        for(ObjectCacheMap::iterator itr=shard._objectCache.begin();
+            itr!=shard._objectCache.end();
+            ++itr)
         {
-            // so update it time stamp.
-            itr->second.second = referenceTime;
+            // if ref count is greater the 1 the object has an external reference.
+            if (itr->second.first.valid() && itr->second.first->referenceCount()>1)
+            {
+                // so update it time stamp.
+                itr->second.second = referenceTime;
+            }
         }
     }
 }
@@ -83,17 +102,19 @@ void ObjectCache::removeExpiredObjectsInCache(double expiryTime)
 {
     std::vector<osg::ref_ptr<osg::Object> > objectsToRemove;
 
+    for (unsigned int i=0; i<NumShards; ++i)
     {
-        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
+        Shard& shard = _shards[i];
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(shard._mutex);
 
         // Remove expired entries from object cache
-        ObjectCacheMap::iterator oitr = _objectCache.begin();
-        while(oitr != _objectCache.end())
+        ObjectCacheMap::iterator oitr = shard._objectCache.begin();
+        while(oitr != shard._objectCache.end())
         {
             if (oitr->second.second<=expiryTime)
             {
                 objectsToRemove.push_back(oitr->second.first);
-                _objectCache.erase(oitr++);
+                oitr = shard._objectCache.erase(oitr);
             }
             else
             {
@@ -106,54 +127,125 @@ void ObjectCache::removeExpiredObjectsInCache(double expiryTime)
     objectsToRemove.clear();
 }
 
+void ObjectCache::updateShard(Shard& shard, double referenceTime, double expiryTime, std::vector<osg::ref_ptr<osg::Object> >& objectsToRemove)
+{
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(shard._mutex);
+
+    ObjectCacheMap::iterator oitr = shard._objectCache.begin();
+    while(oitr != shard._objectCache.end())
+    {
+        if (oitr->second.first.valid() && oitr->second.first->referenceCount()>1)
+        {
+            oitr->second.second = referenceTime;
+            ++oitr;
+        }
+        else if (oitr->second.second<=expiryTime)
+        {
+            objectsToRemove.push_back(oitr->second.first);
+            oitr = shard._objectCache.erase(oitr);
+        }
+        else
+        {
+            ++oitr;
+        }
+    }
+}
+
+void ObjectCache::updateCache(double referenceTime, double expiryTime)
+{
+    // Visit the shards that are due since the previous call, so that every shard is visited once per full update period
+    unsigned int numShards = NumShards;
+    if (_fullUpdatePeriod > 0.0)
+    {
+        double due = std::ceil((referenceTime - _lastUpdateTime) / _fullUpdatePeriod * NumShards);
+        if (due < NumShards)
+            numShards = static_cast<unsigned int>(std::max(1.0, due));
+    }
+    _lastUpdateTime = referenceTime;
+
+    std::vector<osg::ref_ptr<osg::Object> > objectsToRemove;
+
+    for (unsigned int i=0; i<numShards; ++i)
+    {
+        updateShard(_shards[_nextShardToUpdate], referenceTime, expiryTime, objectsToRemove);
+        _nextShardToUpdate = (_nextShardToUpdate+1) % NumShards;
+    }
+
+    // note, actual unref happens outside of the lock
+    objectsToRemove.clear();
+}
+
+void ObjectCache::setFullUpdatePeriod(double period)
+{
+    _fullUpdatePeriod = period;
+}
+
 void ObjectCache::removeFromObjectCache(const std::string& fileName)
 {
-    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
-    ObjectCacheMap::iterator itr = _objectCache.find(fileName);
-    if (itr!=_objectCache.end()) _objectCache.erase(itr);
+    Shard& shard = getShard(fileName);
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(shard._mutex);
+    ObjectCacheMap::iterator itr = shard._objectCache.find(fileName);
+    if (itr!=shard._objectCache.end()) shard._objectCache.erase(itr);
 }
 
 void ObjectCache::clear()
 {
-    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
-    _objectCache.clear();
+    for (unsigned int i=0; i<NumShards; ++i)
+    {
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_shards[i]._mutex);
+        _shards[i]._objectCache.clear();
+    }
 }
 
 void ObjectCache::releaseGLObjects(osg::State* state)
 {
-    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
-
-    for(ObjectCacheMap::iterator itr = _objectCache.begin();
-        itr != _objectCache.end();
-        ++itr)
+    for (unsigned int i=0; i<NumShards; ++i)
     {
-        osg::Object* object = itr->second.first.get();
-        object->releaseGLObjects(state);
+        Shard& shard = _shards[i];
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(shard._mutex);
+
+        for(ObjectCacheMap::iterator itr = shard._objectCache.begin();
+            itr != shard._objectCache.end();
+            ++itr)
+        {
+            osg::Object* object = itr->second.first.get();
+            if (object)
+                object->releaseGLObjects(state);
+        }
     }
 }
 
 void ObjectCache::accept(osg::NodeVisitor &nv)
 {
-    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
-
-    for(ObjectCacheMap::iterator itr = _objectCache.begin();
-        itr != _objectCache.end();
-        ++itr)
+    for (unsigned int i=0; i<NumShards; ++i)
     {
-        osg::Object* object = itr->second.first.get();
-        if (object)
+        Shard& shard = _shards[i];
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(shard._mutex);
+
+        for(ObjectCacheMap::iterator itr = shard._objectCache.begin();
+            itr != shard._objectCache.end();
+            ++itr)
         {
-            osg::Node* node = dynamic_cast<osg::Node*>(object);
-            if (node)
-                node->accept(nv);
+            osg::Object* object = itr->second.first.get();
+            if (object)
+            {
+                osg::Node* node = dynamic_cast<osg::Node*>(object);
+                if (node)
+                    node->accept(nv);
+            }
         }
     }
 }
 
 unsigned int ObjectCache::getCacheSize() const
 {
-    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
-    return _objectCache.size();
+    unsigned int size = 0;
+    for (unsigned int i=0; i<NumShards; ++i)
+    {
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_shards[i]._mutex);
+        size += _shards[i]._objectCache.size();
+    }
+    return size;
 }
 
 }
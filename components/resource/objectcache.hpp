@@ -1,5 +1,6 @@
 // Resource ObjectCache for OpenMW, forked from osgDB ObjectCache by Robert Osfield, see copyright notice below.
 // The main change from the upstream version is that removeExpiredObjectsInCache no longer keeps a lock while the unref happens.
+// In addition, the cache is split into shards with their own locks, and can be maintained incrementally using updateCache.
 
 /* -*-c++-*- OpenSceneGraph - Copyright (C) 1998-2006 Robert Osfield
  *
@@ -20,8 +21,11 @@
 #include <osg/Referenced>
 #include <osg/ref_ptr>
 
+#include <OpenThreads/Mutex>
+
 #include <string>
-#include <map>
+#include <unordered_map>
+#include <vector>
 
 namespace osg
 {
@@ -52,6 +56,17 @@ class ObjectCache : public osg::Referenced
           * after the call to updateTimeStampOfObjectsInCacheWithExternalReferences(expirtyTime).*/
         void removeExpiredObjectsInCache(double expiryTime);
 
+        /** Incremental version of updateTimeStampOfObjectsInCacheWithExternalReferences followed by removeExpiredObjectsInCache.
+          * Only processes the share of shards that is due for the time passed since the previous call (see setFullUpdatePeriod),
+          * continuing with the next shard on the following call. An entry expires once the expiry delay has passed since the last
+          * visit of its shard that found it still referenced, which may be up to one full update period before it was released.
+          * An expired entry is removed the next time its shard is visited, i.e. within one full update period after it expired.*/
+        void updateCache(double referenceTime, double expiryTime);
+
+        /** Set the time within which updateCache should visit every entry once, however often it is called.
+          * 0 (the default) means to always visit all entries.*/
+        void setFullUpdatePeriod(double period);
+
         /** Remove all objects in the cache regardless of having external references or expiry times.*/
         void clear();
 
@@ -77,9 +92,13 @@ class ObjectCache : public osg::Referenced
         template <class Functor>
         void call(Functor& f)
         {
-            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
-            for (ObjectCacheMap::iterator it = _objectCache.begin(); it != _objectCache.end(); ++it)
-                f(it->second.first.get());
+            for (unsigned int i=0; i<NumShards; ++i)
+            {
+                Shard& shard = _shards[i];
+                OpenThreads::ScopedLock<OpenThreads::Mutex> lock(shard._mutex);
+                for (ObjectCacheMap::iterator it = shard._objectCache.begin(); it != shard._objectCache.end(); ++it)
+                    f(it->second.first.get());
+            }
         }
 
         /** Get the number of objects in the cache. */
@@ -90,10 +109,26 @@ class ObjectCache : public osg::Referenced
         virtual ~ObjectCache();
 
         typedef std::pair<osg::ref_ptr<osg::Object>, double >           ObjectTimeStampPair;
-        typedef std::map<std::string, ObjectTimeStampPair >             ObjectCacheMap;
+        typedef std::unordered_map<std::string, ObjectTimeStampPair >   ObjectCacheMap;
+
+        enum { NumShards = 16 };
+
+        struct Shard
+        {
+            ObjectCacheMap                      _objectCache;
+            mutable OpenThreads::Mutex          _mutex;
+        };
+
+        Shard& getShard(const std::string& fileName);
+
+        /** Update time stamps and collect expired objects of one shard.*/
+        void updateShard(Shard& shard, double referenceTime, double expiryTime, std::vector<osg::ref_ptr<osg::Object> >& objectsToRemove);
+
+        Shard                                   _shards[NumShards];
 
-        ObjectCacheMap                          _objectCache;
-        mutable OpenThreads::Mutex              _objectCacheMutex;
+        double                                  _fullUpdatePeriod;
+        double                                  _lastUpdateTime;
+        unsigned int                            _nextShardToUpdate;
 
 };
 
@@ -10,7 +10,6 @@ namespace Resource
         , mCache(new Resource::ObjectCache)
         , mExpiryDelay(0.0)
     {
-
     }
 
     ResourceManager::~ResourceManager()
@@ -19,13 +18,15 @@ namespace Resource
 
     void ResourceManager::updateCache(double referenceTime)
     {
-        mCache->updateTimeStampOfObjectsInCacheWithExternalReferences(referenceTime);
-        mCache->removeExpiredObjectsInCache(referenceTime - mExpiryDelay);
+        mCache->updateCache(referenceTime, referenceTime - mExpiryDelay);
     }
 
     void ResourceManager::setExpiryDelay(double expiryDelay)
     {
         mExpiryDelay = expiryDelay;
+
+        // spread cache maintenance over the updates within the expiry delay, so that large caches don't cause spikes
+        mCache->setFullUpdatePeriod(expiryDelay);
     }
 
     const VFS::Manager* ResourceManager::getVFS() const
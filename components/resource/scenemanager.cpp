@@ -1,6 +1,8 @@
 #include "scenemanager.hpp"
 
 #include <iostream>
+#include <iterator>
+#include <sstream>
 #include <cstdlib>
 
 #include <osg/Node>
@@ -24,6 +26,7 @@
 #include <components/sceneutil/util.hpp>
 #include <components/sceneutil/controller.hpp>
 #include <components/sceneutil/optimizer.hpp>
+#include <components/sceneutil/serialize.hpp>
 
 #include <components/shader/shadervisitor.hpp>
 #include <components/shader/shadermanager.hpp>
@@ -32,6 +35,7 @@
 #include "niffilemanager.hpp"
 #include "objectcache.hpp"
 #include "multiobjectcache.hpp"
+#include "templatecache.hpp"
 
 namespace
 {
@@ -205,6 +209,14 @@ namespace Resource
 
 
 
+    /// @brief Shared state of a template load in progress, waited on by other threads requesting the same file.
+    class LoadingTemplate : public SceneUtil::WorkItem
+    {
+    public:
+        osg::ref_ptr<const osg::Node> mTemplate;
+        std::string mError;
+    };
+
     SceneManager::SceneManager(const VFS::Manager *vfs, Resource::ImageManager* imageManager, Resource::NifFileManager* nifFileManager)
         : ResourceManager(vfs)
         , mShaderManager(new Shader::ShaderManager)
@@ -307,8 +319,8 @@ namespace Resource
 
     bool SceneManager::checkLoaded(const std::string &name, double timeStamp)
     {
-        std::string normalized = name;
-        mVFS->normalizeFilename(normalized);
+        std::string normalizedBuffer;
+        const std::string& normalized = mVFS->normalizeFilename(name, normalizedBuffer);
 
         return mCache->checkInObjectCache(normalized, timeStamp);
     }
@@ -350,7 +362,7 @@ namespace Resource
     {
         std::string ext = getFileExtension(normalizedFilename);
         if (ext == "nif")
-            return NifOsg::Loader::load(nifFileManager->get(normalizedFilename), imageManager);
+            return NifOsg::Loader::load(nifFileManager->get(normalizedFilename, file), imageManager);
         else
         {
             osgDB::ReaderWriter* reader = osgDB::Registry::instance()->getReaderWriterForExtension(ext);
@@ -468,87 +480,242 @@ namespace Resource
 
     osg::ref_ptr<const osg::Node> SceneManager::getTemplate(const std::string &name)
     {
-        std::string normalized = name;
-        mVFS->normalizeFilename(normalized);
+        std::string normalizedBuffer;
+        const std::string& normalized = mVFS->normalizeFilename(name, normalizedBuffer);
 
         osg::ref_ptr<osg::Object> obj = mCache->getRefFromObjectCache(normalized);
         if (obj)
             return osg::ref_ptr<const osg::Node>(static_cast<osg::Node*>(obj.get()));
-        else
+
+        osg::ref_ptr<LoadingTemplate> loading;
         {
-            osg::ref_ptr<osg::Node> loaded;
-            try
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mLoadingMutex);
+            LoadingMap::iterator found = mLoading.find(normalized);
+            if (found != mLoading.end())
+                loading = found->second;
+            else
             {
-                Files::IStreamPtr file = mVFS->get(normalized);
+                // the load may have completed while we were waiting for the lock
+                obj = mCache->getRefFromObjectCache(normalized);
+                if (obj)
+                    return osg::ref_ptr<const osg::Node>(static_cast<osg::Node*>(obj.get()));
 
-                loaded = load(file, normalized, mImageManager, mNifFileManager);
+                mLoading[normalized] = new LoadingTemplate;
             }
-            catch (std::exception& e)
-            {
-                static const char * const sMeshTypes[] = { "nif", "osg", "osgt", "osgb", "osgx", "osg2" };
+        }
+
+        if (loading)
+        {
+            // another thread is already loading this file, wait for its result rather than loading it twice
+            loading->waitTillDone();
+            if (!loading->mTemplate)
+                throw std::runtime_error(loading->mError);
+            return loading->mTemplate;
+        }
 
-                for (unsigned int i=0; i<sizeof(sMeshTypes)/sizeof(sMeshTypes[0]); ++i)
+        osg::ref_ptr<osg::Node> loaded;
+        std::string error;
+        try
+        {
+            loaded = loadTemplate(name, normalized);
+        }
+        catch (std::exception& e)
+        {
+            error = e.what();
+        }
+
+        {
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mLoadingMutex);
+            LoadingMap::iterator found = mLoading.find(normalized);
+            loading = found->second;
+            mLoading.erase(found);
+        }
+        loading->mTemplate = loaded;
+        loading->mError = error;
+        loading->signalDone();
+
+        if (!loaded)
+            throw std::runtime_error(error);
+        return loaded;
+    }
+
+    std::string SceneManager::getTemplateSettingsKey() const
+    {
+        std::ostringstream stream;
+        stream << mForceShaders << mClampLighting << mForcePerPixelLighting << mAutoUseNormalMaps << mAutoUseSpecularMaps
+               << ";" << mNormalMapPattern << ";" << mNormalHeightMapPattern << ";" << mSpecularMapPattern
+               << ";" << getOptimizationOptions() << ";" << NifOsg::Loader::getShowMarkers();
+        return stream.str();
+    }
+
+    osg::ref_ptr<osg::Node> SceneManager::loadTemplate(const std::string &name, std::string normalized)
+    {
+        osg::ref_ptr<osg::Node> loaded;
+        std::string diskCacheKey;
+        try
+        {
+            Files::IStreamPtr file = mVFS->get(normalized);
+
+            if (mTemplateDiskCache && getFileExtension(normalized) == "nif" && canOptimize(normalized))
+            {
+                // read the file only once, both for the key and for converting it on a cache miss
+                std::string data ((std::istreambuf_iterator<char>(*file)), std::istreambuf_iterator<char>());
+                diskCacheKey = mTemplateDiskCache->computeKey(data, getTemplateSettingsKey());
+                osg::ref_ptr<ImageReadCallback> imageCallback (new ImageReadCallback(mImageManager));
+                loaded = mTemplateDiskCache->read(diskCacheKey, imageCallback);
+                if (loaded)
                 {
-                    normalized = "meshes/marker_error." + std::string(sMeshTypes[i]);
-                    if (mVFS->exists(normalized))
-                    {
-                        std::cerr << "Failed to load '" << name << "': " << e.what() << ", using marker_error." << sMeshTypes[i] << " instead" << std::endl;
-                        Files::IStreamPtr file = mVFS->get(normalized);
-                        loaded = load(file, normalized, mImageManager, mNifFileManager);
-                        break;
-                    }
-                }
+                    // shaders were already applied and the template optimized before it was stored,
+                    // only apply the settings that can change at runtime and share state with the other templates
+                    SetFilterSettingsVisitor setFilterSettingsVisitor(mMinFilter, mMagFilter, mMaxAnisotropy);
+                    loaded->accept(setFilterSettingsVisitor);
+
+                    mSharedStateMutex.lock();
+                    mSharedStateManager->share(loaded.get());
+                    mSharedStateMutex.unlock();
+
+                    if (mIncrementalCompileOperation)
+                        mIncrementalCompileOperation->add(loaded);
 
-                if (!loaded)
-                    throw;
+                    mCache->addEntryToObjectCache(normalized, loaded);
+                    return loaded;
+                }
+                file.reset(new std::istringstream(data));
             }
 
-            // set filtering settings
-            SetFilterSettingsVisitor setFilterSettingsVisitor(mMinFilter, mMagFilter, mMaxAnisotropy);
-            loaded->accept(setFilterSettingsVisitor);
-            SetFilterSettingsControllerVisitor setFilterSettingsControllerVisitor(mMinFilter, mMagFilter, mMaxAnisotropy);
-            loaded->accept(setFilterSettingsControllerVisitor);
-
-            Shader::ShaderVisitor shaderVisitor(*mShaderManager.get(), *mImageManager, "objects_vertex.glsl", "objects_fragment.glsl");
-            shaderVisitor.setForceShaders(mForceShaders);
-            shaderVisitor.setClampLighting(mClampLighting);
-            shaderVisitor.setForcePerPixelLighting(mForcePerPixelLighting);
-            shaderVisitor.setAutoUseNormalMaps(mAutoUseNormalMaps);
-            shaderVisitor.setNormalMapPattern(mNormalMapPattern);
-            shaderVisitor.setNormalHeightMapPattern(mNormalHeightMapPattern);
-            shaderVisitor.setAutoUseSpecularMaps(mAutoUseSpecularMaps);
-            shaderVisitor.setSpecularMapPattern(mSpecularMapPattern);
-            loaded->accept(shaderVisitor);
-
-            // share state
-            // do this before optimizing so the optimizer will be able to combine nodes more aggressively
-            // note, because StateSets will be shared at this point, StateSets can not be modified inside the optimizer
-            mSharedStateMutex.lock();
-            mSharedStateManager->share(loaded.get());
-            mSharedStateMutex.unlock();
-
-            if (canOptimize(normalized))
-            {
-                SceneUtil::Optimizer optimizer;
-                optimizer.setIsOperationPermissibleForObjectCallback(new CanOptimizeCallback);
+            loaded = load(file, normalized, mImageManager, mNifFileManager);
+        }
+        catch (std::exception& e)
+        {
+            diskCacheKey.clear();
 
-                static const unsigned int options = getOptimizationOptions();
+            static const char * const sMeshTypes[] = { "nif", "osg", "osgt", "osgb", "osgx", "osg2" };
 
-                optimizer.optimize(loaded, options);
+            for (unsigned int i=0; i<sizeof(sMeshTypes)/sizeof(sMeshTypes[0]); ++i)
+            {
+                normalized = "meshes/marker_error." + std::string(sMeshTypes[i]);
+                if (mVFS->exists(normalized))
+                {
+                    std::cerr << "Failed to load '" << name << "': " << e.what() << ", using marker_error." << sMeshTypes[i] << " instead" << std::endl;
+                    Files::IStreamPtr file = mVFS->get(normalized);
+                    loaded = load(file, normalized, mImageManager, mNifFileManager);
+                    break;
+                }
             }
 
-            if (mIncrementalCompileOperation)
-                mIncrementalCompileOperation->add(loaded);
+            if (!loaded)
+                throw;
+        }
+
+        // set filtering settings
+        SetFilterSettingsVisitor setFilterSettingsVisitor(mMinFilter, mMagFilter, mMaxAnisotropy);
+        loaded->accept(setFilterSettingsVisitor);
+        SetFilterSettingsControllerVisitor setFilterSettingsControllerVisitor(mMinFilter, mMagFilter, mMaxAnisotropy);
+        loaded->accept(setFilterSettingsControllerVisitor);
+
+        Shader::ShaderVisitor shaderVisitor(*mShaderManager.get(), *mImageManager, "objects_vertex.glsl", "objects_fragment.glsl");
+        shaderVisitor.setForceShaders(mForceShaders);
+        shaderVisitor.setClampLighting(mClampLighting);
+        shaderVisitor.setForcePerPixelLighting(mForcePerPixelLighting);
+        shaderVisitor.setAutoUseNormalMaps(mAutoUseNormalMaps);
+        shaderVisitor.setNormalMapPattern(mNormalMapPattern);
+        shaderVisitor.setNormalHeightMapPattern(mNormalHeightMapPattern);
+        shaderVisitor.setAutoUseSpecularMaps(mAutoUseSpecularMaps);
+        shaderVisitor.setSpecularMapPattern(mSpecularMapPattern);
+        loaded->accept(shaderVisitor);
+
+        // share state
+        // do this before optimizing so the optimizer will be able to combine nodes more aggressively
+        // note, because StateSets will be shared at this point, StateSets can not be modified inside the optimizer
+        mSharedStateMutex.lock();
+        mSharedStateManager->share(loaded.get());
+        mSharedStateMutex.unlock();
+
+        if (canOptimize(normalized))
+        {
+            SceneUtil::Optimizer optimizer;
+            optimizer.setIsOperationPermissibleForObjectCallback(new CanOptimizeCallback);
+
+            static const unsigned int options = getOptimizationOptions();
+
+            optimizer.optimize(loaded, options);
+        }
 
-            mCache->addEntryToObjectCache(normalized, loaded);
-            return loaded;
+        if (!diskCacheKey.empty())
+            mTemplateDiskCache->write(diskCacheKey, loaded);
+
+        if (mIncrementalCompileOperation)
+            mIncrementalCompileOperation->add(loaded);
+
+        mCache->addEntryToObjectCache(normalized, loaded);
+        return loaded;
+    }
+
+    TemplateRequest::TemplateRequest(SceneManager *sceneManager, const std::string &name)
+        : mSceneManager(sceneManager)
+        , mName(name)
+    {
+    }
+
+    void TemplateRequest::doWork()
+    {
+        try
+        {
+            mTemplate = mSceneManager->getTemplate(mName);
+        }
+        catch (std::exception& e)
+        {
+            mError = e.what();
         }
     }
 
+    osg::ref_ptr<const osg::Node> TemplateRequest::getTemplate()
+    {
+        waitTillDone();
+        if (!mTemplate)
+            throw std::runtime_error(mError);
+        return mTemplate;
+    }
+
+    const std::string& TemplateRequest::getName() const
+    {
+        return mName;
+    }
+
+    osg::ref_ptr<TemplateRequest> SceneManager::requestTemplate(const std::string &name)
+    {
+        osg::ref_ptr<TemplateRequest> request (new TemplateRequest(this, name));
+        if (mWorkQueue)
+            mWorkQueue->addWorkItem(request);
+        else
+        {
+            request->doWork();
+            request->signalDone();
+        }
+        return request;
+    }
+
+    void SceneManager::setWorkQueue(SceneUtil::WorkQueue *workQueue)
+    {
+        mWorkQueue = workQueue;
+    }
+
+    void SceneManager::setTemplateCachePath(const std::string &path)
+    {
+        if (path.empty())
+        {
+            mTemplateDiskCache.reset();
+            return;
+        }
+
+        SceneUtil::registerTemplateSerializers();
+        mTemplateDiskCache.reset(new TemplateDiskCache(path));
+    }
+
     osg::ref_ptr<osg::Node> SceneManager::cacheInstance(const std::string &name)
     {
-        std::string normalized = name;
-        mVFS->normalizeFilename(normalized);
+        std::string normalizedBuffer;
+        const std::string& normalized = mVFS->normalizeFilename(name, normalizedBuffer);
 
         osg::ref_ptr<osg::Node> node = createInstance(normalized);
         mInstanceCache->addEntryToObjectCache(normalized, node.get());
@@ -594,8 +761,8 @@ namespace Resource
 
     osg::ref_ptr<osg::Node> SceneManager::getInstance(const std::string &name)
     {
-        std::string normalized = name;
-        mVFS->normalizeFilename(normalized);
+        std::string normalizedBuffer;
+        const std::string& normalized = mVFS->normalizeFilename(name, normalizedBuffer);
 
         osg::ref_ptr<osg::Object> obj = mInstanceCache->takeFromObjectCache(normalized);
         if (obj.get())
@@ -9,6 +9,10 @@
 #include <osg/Node>
 #include <osg/Texture>
 
+#include <OpenThreads/Mutex>
+
+#include <components/sceneutil/workqueue.hpp>
+
 #include "resourcemanager.hpp"
 
 namespace Resource
@@ -37,6 +41,32 @@ namespace Resource
 {
 
     class MultiObjectCache;
+    class SceneManager;
+    class TemplateDiskCache;
+
+    /// @brief Result of an asynchronous SceneManager::requestTemplate call.
+    /// @par Use isDone() to poll or waitTillDone() to block until the template is available.
+    class TemplateRequest : public SceneUtil::WorkItem
+    {
+    public:
+        TemplateRequest(SceneManager* sceneManager, const std::string& name);
+
+        virtual void doWork();
+
+        /// Get the loaded template, waiting for the load to complete if necessary.
+        /// @note Throws std::runtime_error if the template (and the error marker mesh) failed to load.
+        osg::ref_ptr<const osg::Node> getTemplate();
+
+        const std::string& getName() const;
+
+    private:
+        SceneManager* mSceneManager;
+        std::string mName;
+        osg::ref_ptr<const osg::Node> mTemplate;
+        std::string mError;
+    };
+
+    class LoadingTemplate;
 
     /// @brief Handles loading and caching of scenes, e.g. .nif files or .osg files
     /// @note Some methods of the scene manager can be used from any thread, see the methods documentation for more details.
@@ -87,6 +117,21 @@ namespace Resource
         /// @note Thread safe.
         osg::ref_ptr<const osg::Node> getTemplate(const std::string& name);
 
+        /// Start loading the given scene template in the background, if it is not loaded already.
+        /// @note Concurrent requests for the same file share a single load, no matter if they come from
+        ///  requestTemplate or getTemplate.
+        /// @note If no work queue was set, the template is loaded on the calling thread before returning.
+        /// @note Thread safe.
+        osg::ref_ptr<TemplateRequest> requestTemplate(const std::string& name);
+
+        /// Set the work queue to be used by requestTemplate.
+        void setWorkQueue(SceneUtil::WorkQueue* workQueue);
+
+        /// Store processed templates in the given directory and reuse them on later runs, unless the source file or
+        /// the settings affecting the template have changed. An empty path disables the template disk cache.
+        /// @note Not thread safe, should be called before any templates are loaded.
+        void setTemplateCachePath(const std::string& path);
+
         /// Create an instance of the given scene template and cache it for later use, so that future calls to getInstance() can simply
         /// return this cached object instead of creating a new one.
         /// @note The returned ref_ptr may be kept around by the caller to ensure that the object stays in cache for as long as needed.
@@ -147,6 +192,12 @@ namespace Resource
 
     private:
 
+        /// Load, process and cache the template, falling back to the error marker mesh if necessary.
+        osg::ref_ptr<osg::Node> loadTemplate(const std::string& name, std::string normalized);
+
+        /// Describes the settings affecting processed templates, used as part of the template disk cache key.
+        std::string getTemplateSettingsKey() const;
+
         std::unique_ptr<Shader::ShaderManager> mShaderManager;
         bool mForceShaders;
         bool mClampLighting;
@@ -172,6 +223,15 @@ namespace Resource
 
         osg::ref_ptr<osgUtil::IncrementalCompileOperation> mIncrementalCompileOperation;
 
+        osg::ref_ptr<SceneUtil::WorkQueue> mWorkQueue;
+
+        std::unique_ptr<TemplateDiskCache> mTemplateDiskCache;
+
+        /// Templates currently being loaded, so that concurrent requests for the same file can wait for the pending load.
+        typedef std::map<std::string, osg::ref_ptr<LoadingTemplate> > LoadingMap;
+        LoadingMap mLoading;
+        OpenThreads::Mutex mLoadingMutex;
+
         unsigned int mParticleSystemMask;
 
         SceneManager(const SceneManager&);
@@ -0,0 +1,274 @@
+#include "templatecache.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <osg/Node>
+#include <osg/Drawable>
+#include <osg/NodeVisitor>
+#include <osg/Program>
+#include <osg/Texture>
+#include <osg/UserDataContainer>
+
+#include <osgDB/Registry>
+#include <osgDB/ObjectWrapper>
+
+#include <components/nifosg/userdata.hpp>
+
+namespace
+{
+
+    // Increase whenever NifOsg::Loader, SceneUtil::Optimizer or the processing in SceneManager::loadTemplate
+    // change their output, so that entries written by older versions are no longer used.
+    const unsigned int sTemplateCacheVersion = 1;
+
+    /// @brief Checks if a scene graph consists only of objects that can be stored in the .osgb format without loss.
+    class StorableVisitor : public osg::NodeVisitor
+    {
+    public:
+        StorableVisitor()
+            : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN)
+            , mStorable(true)
+        {
+        }
+
+        virtual void apply(osg::Node& node)
+        {
+            checkObject(&node);
+            checkCallback(node.getUpdateCallback());
+            checkCallback(node.getEventCallback());
+            checkCallback(node.getCullCallback());
+            checkObject(node.getComputeBoundingSphereCallback());
+            checkStateSet(node.getStateSet());
+
+            if (const osg::UserDataContainer* container = node.getUserDataContainer())
+            {
+                checkObject(container);
+                checkObject(container->getUserData());
+                for (unsigned int i=0; i<container->getNumUserObjects(); ++i)
+                    checkObject(container->getUserObject(i));
+            }
+
+            if (mStorable)
+                traverse(node);
+        }
+
+        virtual void apply(osg::Drawable& drawable)
+        {
+            checkObject(drawable.getDrawCallback());
+            checkObject(drawable.getComputeBoundingBoxCallback());
+            apply(static_cast<osg::Node&>(drawable));
+        }
+
+        bool isStorable() const
+        {
+            return mStorable;
+        }
+
+    private:
+        void checkObject(const osg::Object* object)
+        {
+            if (!object)
+                return;
+
+            // NodeUserData has a serializer, see SceneUtil::registerTemplateSerializers
+            if (dynamic_cast<const NifOsg::NodeUserData*>(object))
+                return;
+
+            // Custom classes from our own libraries or from osgParticle etc. have no (complete) serializers
+            if (std::string(object->libraryName()) != "osg")
+                mStorable = false;
+
+            // Shader sources are read from the resources folder, which may change between runs
+            if (dynamic_cast<const osg::Program*>(object))
+                mStorable = false;
+        }
+
+        void checkCallback(const osg::Callback* callback)
+        {
+            for (; callback; callback = callback->getNestedCallback())
+                checkObject(callback);
+        }
+
+        void checkStateAttribute(const osg::StateAttribute* attr)
+        {
+            checkObject(attr);
+            checkCallback(attr->getUpdateCallback());
+            checkCallback(attr->getEventCallback());
+
+            if (const osg::Texture* texture = attr->asTexture())
+            {
+                // images are stored by file name and read through the ImageManager again, which requires a name
+                for (unsigned int i=0; i<texture->getNumImages(); ++i)
+                {
+                    const osg::Image* image = texture->getImage(i);
+                    if (image && image->getFileName().empty())
+                        mStorable = false;
+                }
+            }
+        }
+
+        void checkStateSet(const osg::StateSet* stateset)
+        {
+            if (!stateset)
+                return;
+
+            checkObject(stateset);
+            checkCallback(stateset->getUpdateCallback());
+            checkCallback(stateset->getEventCallback());
+
+            const osg::StateSet::AttributeList& attributes = stateset->getAttributeList();
+            for (osg::StateSet::AttributeList::const_iterator it = attributes.begin(); it != attributes.end(); ++it)
+                checkStateAttribute(it->second.first.get());
+
+            const osg::StateSet::TextureAttributeList& texAttributes = stateset->getTextureAttributeList();
+            for (unsigned int unit=0; unit<texAttributes.size(); ++unit)
+            {
+                for (osg::StateSet::AttributeList::const_iterator it = texAttributes[unit].begin(); it != texAttributes[unit].end(); ++it)
+                    checkStateAttribute(it->second.first.get());
+            }
+
+            const osg::StateSet::UniformList& uniforms = stateset->getUniformList();
+            for (osg::StateSet::UniformList::const_iterator it = uniforms.begin(); it != uniforms.end(); ++it)
+            {
+                checkObject(it->second.first.get());
+                checkCallback(it->second.first->getUpdateCallback());
+                checkCallback(it->second.first->getEventCallback());
+            }
+        }
+
+        bool mStorable;
+    };
+
+    /// The debugging serializers registered by SceneUtil::registerSerializers replace the osg::Geometry serializer
+    /// with one that omits the vertex data, in that case nothing can be stored or read.
+    bool canSerializeGeometry()
+    {
+        osgDB::ObjectWrapper* wrapper = osgDB::Registry::instance()->getObjectWrapperManager()->findWrapper("osg::Geometry");
+        return wrapper && wrapper->getSerializer("VertexArray");
+    }
+
+    void hashBytes(unsigned long long& hash, const char* data, size_t size)
+    {
+        // 64-bit FNV-1a
+        for (size_t i=0; i<size; ++i)
+        {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 1099511628211ull;
+        }
+    }
+
+}
+
+namespace Resource
+{
+
+    TemplateDiskCache::TemplateDiskCache(const std::string &path)
+        : mPath(path)
+    {
+        try
+        {
+            boost::filesystem::create_directories(boost::filesystem::path(mPath));
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "Failed to create template cache directory '" << mPath << "': " << e.what() << std::endl;
+        }
+    }
+
+    std::string TemplateDiskCache::computeKey(const std::string &source, const std::string &settings) const
+    {
+        unsigned long long hash = 14695981039346656037ull;
+
+        std::ostringstream header;
+        header << sTemplateCacheVersion << ";" << settings << ";";
+        const std::string headerStr = header.str();
+        hashBytes(hash, headerStr.c_str(), headerStr.size());
+
+        hashBytes(hash, source.data(), source.size());
+
+        std::ostringstream key;
+        key << std::hex << std::setw(16) << std::setfill('0') << hash;
+        return key.str();
+    }
+
+    std::string TemplateDiskCache::getFilename(const std::string &key) const
+    {
+        return (boost::filesystem::path(mPath) / (key + ".osgb")).string();
+    }
+
+    osg::ref_ptr<osg::Node> TemplateDiskCache::read(const std::string &key, osgDB::ReadFileCallback *imageCallback) const
+    {
+        std::string filename = getFilename(key);
+        if (!boost::filesystem::exists(filename) || !canSerializeGeometry())
+            return osg::ref_ptr<osg::Node>();
+
+        osgDB::ReaderWriter* rw = osgDB::Registry::instance()->getReaderWriterForExtension("osgb");
+        if (!rw)
+            return osg::ref_ptr<osg::Node>();
+
+        boost::filesystem::ifstream stream(filename, std::ios_base::binary);
+        if (!stream)
+            return osg::ref_ptr<osg::Node>();
+
+        osg::ref_ptr<osgDB::Options> options (new osgDB::Options);
+        options->setReadFileCallback(imageCallback);
+
+        osgDB::ReaderWriter::ReadResult result = rw->readNode(stream, options);
+        if (!result.success())
+        {
+            std::cerr << "Failed to read template cache entry '" << filename << "': " << result.message() << std::endl;
+            return osg::ref_ptr<osg::Node>();
+        }
+        return result.getNode();
+    }
+
+    void TemplateDiskCache::write(const std::string &key, const osg::Node *node) const
+    {
+        StorableVisitor visitor;
+        const_cast<osg::Node*>(node)->accept(visitor); // const-trickery required because there is no const version of NodeVisitor
+        if (!visitor.isStorable() || !canSerializeGeometry())
+            return;
+
+        osgDB::ReaderWriter* rw = osgDB::Registry::instance()->getReaderWriterForExtension("osgb");
+        if (!rw)
+            return;
+
+        std::string filename = getFilename(key);
+        // write to a temporary file first so that other processes never see an incomplete entry,
+        // with a unique name because other threads or processes may be writing the same entry
+        std::string tempFilename = filename + "." + boost::filesystem::unique_path().string() + ".tmp";
+
+        try
+        {
+            {
+                boost::filesystem::ofstream stream(tempFilename, std::ios_base::binary);
+                if (!stream)
+                    return;
+
+                osg::ref_ptr<osgDB::Options> options (new osgDB::Options("WriteImageHint=UseExternal"));
+                osgDB::ReaderWriter::WriteResult result = rw->writeNode(*node, stream, options);
+                if (!result.success())
+                {
+                    std::cerr << "Failed to write template cache entry '" << filename << "': " << result.message() << std::endl;
+                    stream.close();
+                    boost::filesystem::remove(tempFilename);
+                    return;
+                }
+            }
+
+            boost::filesystem::rename(tempFilename, filename);
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "Failed to write template cache entry '" << filename << "': " << e.what() << std::endl;
+            boost::system::error_code ec;
+            boost::filesystem::remove(tempFilename, ec);
+        }
+    }
+
+}
@@ -0,0 +1,52 @@
+#ifndef OPENMW_COMPONENTS_RESOURCE_TEMPLATECACHE_H
+#define OPENMW_COMPONENTS_RESOURCE_TEMPLATECACHE_H
+
+#include <string>
+
+#include <osg/ref_ptr>
+
+namespace osg
+{
+    class Node;
+}
+
+namespace osgDB
+{
+    class ReadFileCallback;
+}
+
+namespace Resource
+{
+
+    /// @brief Persistent cache of processed scene templates on disk, stored in the OSG binary format (.osgb).
+    /// @par Entries are keyed by a hash of the source file's contents, the loader version and any settings that affect
+    /// the processed template, so stale entries are never used. Only templates made up entirely of classes that can be
+    /// stored without loss are written, other templates simply have to be converted again on the next run.
+    /// @note Thread safe.
+    class TemplateDiskCache
+    {
+    public:
+        /// @param path Directory to store the cache entries in. Will be created if it does not exist.
+        TemplateDiskCache(const std::string& path);
+
+        /// Compute the cache key for the given source file contents.
+        /// @param settings String describing all settings that affect the processed template.
+        std::string computeKey(const std::string& source, const std::string& settings) const;
+
+        /// Read the template stored with the given key.
+        /// @param imageCallback Callback used to read the image files referenced by the template.
+        /// @return The template, or an empty ref_ptr if there is no valid cache entry.
+        osg::ref_ptr<osg::Node> read(const std::string& key, osgDB::ReadFileCallback* imageCallback) const;
+
+        /// Store the given template with the given key, unless it contains objects that can not be stored without loss.
+        void write(const std::string& key, const osg::Node* node) const;
+
+    private:
+        std::string getFilename(const std::string& key) const;
+
+        std::string mPath;
+    };
+
+}
+
+#endif
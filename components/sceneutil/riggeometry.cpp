@@ -4,6 +4,11 @@
 #include <iostream>
 #include <cstdlib>
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define OPENMW_RIGGEOMETRY_SSE
+#endif
+
 #include "skeleton.hpp"
 #include "util.hpp"
 
@@ -66,6 +71,7 @@ public:
 RigGeometry::RigGeometry()
     : mSkeleton(NULL)
     , mLastFrameNumber(0)
+    , mLastSkinnedVersion(0)
     , mBoundsFirstFrame(true)
 {
     setCullCallback(new UpdateRigGeometry);
@@ -80,6 +86,7 @@ RigGeometry::RigGeometry(const RigGeometry &copy, const osg::CopyOp &copyop)
     , mSkeleton(NULL)
     , mInfluenceMap(copy.mInfluenceMap)
     , mLastFrameNumber(0)
+    , mLastSkinnedVersion(0)
     , mBoundsFirstFrame(true)
 {
     setSourceGeometry(copy.mSourceGeometry);
@@ -172,6 +179,9 @@ bool RigGeometry::initFromParentSkeleton(osg::NodeVisitor* nv)
         return false;
     }
 
+    mBones.clear();
+    mBoneSphereMap.clear();
+
     typedef std::map<unsigned short, std::vector<BoneWeight> > Vertex2BoneMap;
     Vertex2BoneMap vertex2BoneMap;
     for (std::map<std::string, BoneInfluence>::const_iterator it = mInfluenceMap->mMap.begin(); it != mInfluenceMap->mMap.end(); ++it)
@@ -186,30 +196,76 @@ bool RigGeometry::initFromParentSkeleton(osg::NodeVisitor* nv)
         mBoneSphereMap[bone] = it->second.mBoundSphere;
 
         const BoneInfluence& bi = it->second;
+        const size_t boneIndex = mBones.size();
+        mBones.push_back(std::make_pair(bone, bi.mInvBindMatrix));
 
         const std::map<unsigned short, float>& weights = it->second.mWeights;
         for (std::map<unsigned short, float>::const_iterator weightIt = weights.begin(); weightIt != weights.end(); ++weightIt)
         {
             std::vector<BoneWeight>& vec = vertex2BoneMap[weightIt->first];
 
-            BoneWeight b = std::make_pair(std::make_pair(bone, bi.mInvBindMatrix), weightIt->second);
-
-            vec.push_back(b);
+            vec.push_back(std::make_pair(boneIndex, weightIt->second));
         }
     }
+    mSkinningMatrices.resize(mBones.size());
 
+    Bone2VertexMap bone2VertexMap;
     for (Vertex2BoneMap::iterator it = vertex2BoneMap.begin(); it != vertex2BoneMap.end(); ++it)
     {
-        mBone2VertexMap[it->second].push_back(it->first);
+        bone2VertexMap[it->second].push_back(it->first);
+    }
+
+    mVertexGroups.clear();
+    mWeights.clear();
+    mVertices.clear();
+    for (Bone2VertexMap::const_iterator it = bone2VertexMap.begin(); it != bone2VertexMap.end(); ++it)
+    {
+        VertexGroup group;
+        group.mFirstWeight = mWeights.size();
+        group.mNumWeights = it->first.size();
+        group.mFirstVertex = mVertices.size();
+        group.mNumVertices = it->second.size();
+        mVertexGroups.push_back(group);
+
+        mWeights.insert(mWeights.end(), it->first.begin(), it->first.end());
+        mVertices.insert(mVertices.end(), it->second.begin(), it->second.end());
     }
 
+    buildSourceStreams();
+
     return true;
 }
 
-void accumulateMatrix(const osg::Matrixf& invBindMatrix, const osg::Matrixf& matrix, float weight, osg::Matrixf& result)
+void RigGeometry::buildSourceStreams()
 {
-    osg::Matrixf m = invBindMatrix * matrix;
-    float* ptr = m.ptr();
+    const osg::Vec3Array* positionSrc = static_cast<const osg::Vec3Array*>(mSourceGeometry->getVertexArray());
+    const osg::Vec3Array* normalSrc = static_cast<const osg::Vec3Array*>(mSourceGeometry->getNormalArray());
+    const osg::Vec4Array* tangentSrc = mSourceTangents;
+
+    for (int i=0; i<3; ++i)
+    {
+        mSourcePositions[i].resize(mVertices.size());
+        mSourceNormals[i].resize(normalSrc ? mVertices.size() : 0);
+        mSourceTangentDirections[i].resize(tangentSrc ? mVertices.size() : 0);
+    }
+
+    for (size_t i=0; i<mVertices.size(); ++i)
+    {
+        const unsigned short vertex = mVertices[i];
+        for (int c=0; c<3; ++c)
+        {
+            mSourcePositions[c][i] = (*positionSrc)[vertex][c];
+            if (normalSrc)
+                mSourceNormals[c][i] = (*normalSrc)[vertex][c];
+            if (tangentSrc)
+                mSourceTangentDirections[c][i] = (*tangentSrc)[vertex][c];
+        }
+    }
+}
+
+void accumulateMatrix(const osg::Matrixf& matrix, float weight, osg::Matrixf& result)
+{
+    const float* ptr = matrix.ptr();
     float* ptrresult = result.ptr();
     ptrresult[0] += ptr[0] * weight;
     ptrresult[1] += ptr[1] * weight;
@@ -228,6 +284,65 @@ void accumulateMatrix(const osg::Matrixf& invBindMatrix, const osg::Matrixf& mat
     ptrresult[14] += ptr[14] * weight;
 }
 
+/// Transform \a count vertices, given as one source stream per component, by the affine \a matrix and
+/// write the results to the elements of \a dst selected by \a vertices.
+/// @param translate Apply the translation part of the matrix, i.e. transform positions rather than directions.
+/// @param dstStride Number of floats per element of \a dst.
+void skinVertices(const osg::Matrixf& matrix, bool translate, const float* x, const float* y, const float* z, size_t count,
+                  const unsigned short* vertices, float* dst, size_t dstStride)
+{
+    const float* m = matrix.ptr();
+    size_t i = 0;
+
+#ifdef OPENMW_RIGGEOMETRY_SSE
+    const __m128 m0 = _mm_set1_ps(m[0]);
+    const __m128 m1 = _mm_set1_ps(m[1]);
+    const __m128 m2 = _mm_set1_ps(m[2]);
+    const __m128 m4 = _mm_set1_ps(m[4]);
+    const __m128 m5 = _mm_set1_ps(m[5]);
+    const __m128 m6 = _mm_set1_ps(m[6]);
+    const __m128 m8 = _mm_set1_ps(m[8]);
+    const __m128 m9 = _mm_set1_ps(m[9]);
+    const __m128 m10 = _mm_set1_ps(m[10]);
+    const __m128 t0 = translate ? _mm_set1_ps(m[12]) : _mm_setzero_ps();
+    const __m128 t1 = translate ? _mm_set1_ps(m[13]) : _mm_setzero_ps();
+    const __m128 t2 = translate ? _mm_set1_ps(m[14]) : _mm_setzero_ps();
+
+    float resultX[4];
+    float resultY[4];
+    float resultZ[4];
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128 vx = _mm_loadu_ps(x + i);
+        const __m128 vy = _mm_loadu_ps(y + i);
+        const __m128 vz = _mm_loadu_ps(z + i);
+
+        _mm_storeu_ps(resultX, _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, m0), _mm_mul_ps(vy, m4)), _mm_add_ps(_mm_mul_ps(vz, m8), t0)));
+        _mm_storeu_ps(resultY, _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, m1), _mm_mul_ps(vy, m5)), _mm_add_ps(_mm_mul_ps(vz, m9), t1)));
+        _mm_storeu_ps(resultZ, _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, m2), _mm_mul_ps(vy, m6)), _mm_add_ps(_mm_mul_ps(vz, m10), t2)));
+
+        for (int j=0; j<4; ++j)
+        {
+            float* out = dst + vertices[i+j] * dstStride;
+            out[0] = resultX[j];
+            out[1] = resultY[j];
+            out[2] = resultZ[j];
+        }
+    }
+#endif
+
+    const float tx = translate ? m[12] : 0.f;
+    const float ty = translate ? m[13] : 0.f;
+    const float tz = translate ? m[14] : 0.f;
+    for (; i < count; ++i)
+    {
+        float* out = dst + vertices[i] * dstStride;
+        out[0] = x[i] * m[0] + y[i] * m[4] + z[i] * m[8] + tx;
+        out[1] = x[i] * m[1] + y[i] * m[5] + z[i] * m[9] + ty;
+        out[2] = x[i] * m[2] + y[i] * m[6] + z[i] * m[10] + tz;
+    }
+}
+
 void RigGeometry::update(osg::NodeVisitor* nv)
 {
     if (!mSkeleton)
@@ -247,46 +362,47 @@ void RigGeometry::update(osg::NodeVisitor* nv)
 
     mSkeleton->updateBoneMatrices(nv->getTraversalNumber());
 
-    // skinning
-    osg::Vec3Array* positionSrc = static_cast<osg::Vec3Array*>(mSourceGeometry->getVertexArray());
-    osg::Vec3Array* normalSrc = static_cast<osg::Vec3Array*>(mSourceGeometry->getNormalArray());
-    osg::Vec4Array* tangentSrc = mSourceTangents;
+    // nothing to do if neither the pose nor the transform into skeleton space changed since we were last skinned,
+    // e.g. for a paused idle or a corpse
+    const osg::Matrix geomToSkelMatrix = mGeomToSkelMatrix ? osg::Matrix(*mGeomToSkelMatrix) : osg::Matrix();
+    if (mSkeleton->getBoneMatricesVersion() == mLastSkinnedVersion && geomToSkelMatrix == mLastSkinnedGeomToSkelMatrix)
+        return;
+    mLastSkinnedVersion = mSkeleton->getBoneMatricesVersion();
+    mLastSkinnedGeomToSkelMatrix = geomToSkelMatrix;
+
+    for (size_t i=0; i<mBones.size(); ++i)
+        mSkinningMatrices[i] = mBones[i].second * mBones[i].first->mMatrixInSkeletonSpace;
 
+    // skinning
     osg::Vec3Array* positionDst = static_cast<osg::Vec3Array*>(getVertexArray());
-    osg::Vec3Array* normalDst = static_cast<osg::Vec3Array*>(getNormalArray());
-    osg::Vec4Array* tangentDst = static_cast<osg::Vec4Array*>(getTexCoordArray(7));
+    osg::Vec3Array* normalDst = mSourceNormals[0].empty() ? NULL : static_cast<osg::Vec3Array*>(getNormalArray());
+    osg::Vec4Array* tangentDst = mSourceTangentDirections[0].empty() ? NULL : static_cast<osg::Vec4Array*>(getTexCoordArray(7));
 
-    for (Bone2VertexMap::const_iterator it = mBone2VertexMap.begin(); it != mBone2VertexMap.end(); ++it)
+    for (std::vector<VertexGroup>::const_iterator it = mVertexGroups.begin(); it != mVertexGroups.end(); ++it)
     {
         osg::Matrixf resultMat  (0, 0, 0, 0,
                                 0, 0, 0, 0,
                                 0, 0, 0, 0,
                                 0, 0, 0, 1);
 
-        for (std::vector<BoneWeight>::const_iterator weightIt = it->first.begin(); weightIt != it->first.end(); ++weightIt)
-        {
-            Bone* bone = weightIt->first.first;
-            const osg::Matrix& invBindMatrix = weightIt->first.second;
-            float weight = weightIt->second;
-            const osg::Matrixf& boneMatrix = bone->mMatrixInSkeletonSpace;
-            accumulateMatrix(invBindMatrix, boneMatrix, weight, resultMat);
-        }
+        for (size_t i = it->mFirstWeight; i < it->mFirstWeight + it->mNumWeights; ++i)
+            accumulateMatrix(mSkinningMatrices[mWeights[i].first], mWeights[i].second, resultMat);
+
         if (mGeomToSkelMatrix)
             resultMat *= (*mGeomToSkelMatrix);
 
-        for (std::vector<unsigned short>::const_iterator vertexIt = it->second.begin(); vertexIt != it->second.end(); ++vertexIt)
-        {
-            unsigned short vertex = *vertexIt;
-            (*positionDst)[vertex] = resultMat.preMult((*positionSrc)[vertex]);
-            if (normalDst)
-                (*normalDst)[vertex] = osg::Matrix::transform3x3((*normalSrc)[vertex], resultMat);
-            if (tangentDst)
-            {
-                osg::Vec4f srcTangent = (*tangentSrc)[vertex];
-                osg::Vec3f transformedTangent = osg::Matrix::transform3x3(osg::Vec3f(srcTangent.x(), srcTangent.y(), srcTangent.z()), resultMat);
-                (*tangentDst)[vertex] = osg::Vec4f(transformedTangent, srcTangent.w());
-            }
-        }
+        const size_t first = it->mFirstVertex;
+        const unsigned short* vertices = &mVertices[first];
+
+        skinVertices(resultMat, true, &mSourcePositions[0][first], &mSourcePositions[1][first], &mSourcePositions[2][first],
+                     it->mNumVertices, vertices, (*positionDst)[0].ptr(), osg::Vec3f::num_components);
+        if (normalDst)
+            skinVertices(resultMat, false, &mSourceNormals[0][first], &mSourceNormals[1][first], &mSourceNormals[2][first],
+                         it->mNumVertices, vertices, (*normalDst)[0].ptr(), osg::Vec3f::num_components);
+        // the w component of tangents is left as copied from the source
+        if (tangentDst)
+            skinVertices(resultMat, false, &mSourceTangentDirections[0][first], &mSourceTangentDirections[1][first],
+                         &mSourceTangentDirections[2][first], it->mNumVertices, vertices, (*tangentDst)[0].ptr(), osg::Vec4f::num_components);
     }
 
     positionDst->dirty();
@@ -356,8 +472,9 @@ void RigGeometry::updateGeomToSkelMatrix(const osg::NodePath& nodePath)
             }
         }
     }
-    if (geomToSkelMatrix && !geomToSkelMatrix->isIdentity())
-        mGeomToSkelMatrix = geomToSkelMatrix;
+    if (geomToSkelMatrix && geomToSkelMatrix->isIdentity())
+        geomToSkelMatrix = NULL;
+    mGeomToSkelMatrix = geomToSkelMatrix;
 }
 
 void RigGeometry::setInfluenceMap(osg::ref_ptr<InfluenceMap> influenceMap)
@@ -2,6 +2,7 @@
 #define OPENMW_COMPONENTS_NIFOSG_RIGGEOMETRY_H
 
 #include <osg/Geometry>
+#include <osg/Matrix>
 #include <osg/Matrixf>
 
 namespace SceneUtil
@@ -62,23 +63,52 @@ namespace SceneUtil
 
         typedef std::pair<Bone*, osg::Matrixf> BoneBindMatrixPair;
 
-        typedef std::pair<BoneBindMatrixPair, float> BoneWeight;
+        // <index into mBones, weight>
+        typedef std::pair<size_t, float> BoneWeight;
 
         typedef std::vector<unsigned short> VertexList;
 
         typedef std::map<std::vector<BoneWeight>, VertexList> Bone2VertexMap;
 
-        Bone2VertexMap mBone2VertexMap;
+        // Flattened form of a Bone2VertexMap, built once in initFromParentSkeleton so the skinning loop
+        // only walks contiguous arrays.
+        struct VertexGroup
+        {
+            size_t mFirstWeight;
+            size_t mNumWeights;
+            size_t mFirstVertex;
+            size_t mNumVertices;
+        };
+        std::vector<VertexGroup> mVertexGroups;
+
+        std::vector<BoneWeight> mWeights;
+        std::vector<unsigned short> mVertices;
+
+        // The bones of the influence map with their inverse bind matrix. The product with the bone matrix is
+        // computed once per frame into mSkinningMatrices, no matter how many vertex groups the bone influences.
+        std::vector<BoneBindMatrixPair> mBones;
+        std::vector<osg::Matrixf> mSkinningMatrices;
+
+        // Source vertex data in the order of mVertices, with one stream per component for the SIMD skinning kernel.
+        std::vector<float> mSourcePositions[3];
+        std::vector<float> mSourceNormals[3];
+        std::vector<float> mSourceTangentDirections[3];
 
         typedef std::map<Bone*, osg::BoundingSpheref> BoneSphereMap;
 
         BoneSphereMap mBoneSphereMap;
 
         unsigned int mLastFrameNumber;
+        // Skeleton::getBoneMatricesVersion() when we were last skinned, 0 if we need to be skinned regardless
+        unsigned int mLastSkinnedVersion;
+        // *mGeomToSkelMatrix when we were last skinned, identity if there was none
+        osg::Matrix mLastSkinnedGeomToSkelMatrix;
         bool mBoundsFirstFrame;
 
         bool initFromParentSkeleton(osg::NodeVisitor* nv);
 
+        void buildSourceStreams();
+
         void updateGeomToSkelMatrix(const osg::NodePath& nodePath);
     };
 
@@ -2,6 +2,11 @@
 
 #include <osgDB/ObjectWrapper>
 #include <osgDB/Registry>
+#include <osgDB/Serializer>
+#include <osgDB/InputStream>
+#include <osgDB/OutputStream>
+
+#include <components/nifosg/userdata.hpp>
 
 #include <components/sceneutil/positionattitudetransform.hpp>
 #include <components/sceneutil/skeleton.hpp>
@@ -73,6 +78,41 @@ public:
     }
 };
 
+static bool checkNodeUserData(const NifOsg::NodeUserData& data)
+{
+    return true;
+}
+
+static bool readNodeUserData(osgDB::InputStream& is, NifOsg::NodeUserData& data)
+{
+    is >> data.mIndex >> data.mScale;
+    for (int i=0; i<3; ++i)
+        for (int j=0; j<3; ++j)
+            is >> data.mRotationScale.mValues[i][j];
+    return true;
+}
+
+static bool writeNodeUserData(osgDB::OutputStream& os, const NifOsg::NodeUserData& data)
+{
+    os << data.mIndex << data.mScale;
+    for (int i=0; i<3; ++i)
+        for (int j=0; j<3; ++j)
+            os << data.mRotationScale.mValues[i][j];
+    os << std::endl;
+    return true;
+}
+
+class NodeUserDataSerializer : public osgDB::ObjectWrapper
+{
+public:
+    NodeUserDataSerializer()
+        : osgDB::ObjectWrapper(createInstanceFunc<NifOsg::NodeUserData>, "NifOsg::NodeUserData", "osg::Object NifOsg::NodeUserData")
+    {
+        addSerializer( new osgDB::UserSerializer<NifOsg::NodeUserData>(
+            "Data", &checkNodeUserData, &readNodeUserData, &writeNodeUserData) );
+    }
+};
+
 osgDB::ObjectWrapper* makeDummySerializer(const std::string& classname)
 {
     return new osgDB::ObjectWrapper(createInstanceFunc<osg::DummyObject>, classname, "osg::Object");
@@ -87,11 +127,25 @@ public:
     }
 };
 
+void registerTemplateSerializers()
+{
+    static bool done = false;
+    if (!done)
+    {
+        osgDB::ObjectWrapperManager* mgr = osgDB::Registry::instance()->getObjectWrapperManager();
+        mgr->addWrapper(new NodeUserDataSerializer);
+
+        done = true;
+    }
+}
+
 void registerSerializers()
 {
     static bool done = false;
     if (!done)
     {
+        registerTemplateSerializers();
+
         osgDB::ObjectWrapperManager* mgr = osgDB::Registry::instance()->getObjectWrapperManager();
         mgr->addWrapper(new PositionAttitudeTransformSerializer);
         mgr->addWrapper(new SkeletonSerializer);
@@ -114,7 +168,6 @@ void registerSerializers()
             "SceneUtil::UpdateRigGeometry",
             "SceneUtil::LightSource",
             "SceneUtil::StateSetUpdater",
-            "NifOsg::NodeUserData",
             "NifOsg::FlipController",
             "NifOsg::KeyframeController",
             "NifOsg::TextKeyMapHolder",
@@ -7,6 +7,10 @@ namespace SceneUtil
     /// Register osg node serializers for certain SceneUtil classes if not already done so
     void registerSerializers();
 
+    /// Register serializers required to store processed scene templates without loss, if not already done so.
+    /// @note Unlike registerSerializers(), this does not replace any of the built-in osg serializers.
+    void registerTemplateSerializers();
+
 }
 
 #endif
@@ -6,6 +6,7 @@
 #include <components/misc/stringops.hpp>
 
 #include <iostream>
+#include <algorithm>
 
 namespace SceneUtil
 {
@@ -36,6 +37,14 @@ private:
 Skeleton::Skeleton()
     : mBoneCacheInit(false)
     , mNeedToUpdateBoneMatrices(true)
+    , mBoneMatricesVersion(1)
+    , mThrottlingDistance(0.f)
+    , mThrottlingInterval(1)
+    , mLastUnthrottledFrame(0)
+    , mThrottlingFrame(0)
+    , mThrottled(false)
+    , mDistanceToViewer(0.f)
+    , mDistanceFrame(0)
     , mActive(true)
     , mLastFrameNumber(0)
     , mTraversedEvenFrame(false)
@@ -48,6 +57,14 @@ Skeleton::Skeleton(const Skeleton &copy, const osg::CopyOp &copyop)
     : osg::Group(copy, copyop)
     , mBoneCacheInit(false)
     , mNeedToUpdateBoneMatrices(true)
+    , mBoneMatricesVersion(1)
+    , mThrottlingDistance(copy.mThrottlingDistance)
+    , mThrottlingInterval(copy.mThrottlingInterval)
+    , mLastUnthrottledFrame(0)
+    , mThrottlingFrame(0)
+    , mThrottled(false)
+    , mDistanceToViewer(0.f)
+    , mDistanceFrame(0)
     , mActive(copy.mActive)
     , mLastFrameNumber(0)
     , mTraversedEvenFrame(false)
@@ -110,7 +127,9 @@ Bone* Skeleton::getBone(const std::string &name)
 
 void Skeleton::updateBoneMatrices(unsigned int traversalNumber)
 {
-    if (traversalNumber != mLastFrameNumber)
+    // Skipping frames for both rigs of a FrameSwitch alike keeps them showing the same pose,
+    // so a throttled skeleton never appears to jump back and forth
+    if (traversalNumber != mLastFrameNumber && !isThrottled(traversalNumber))
         mNeedToUpdateBoneMatrices = true;
 
     mLastFrameNumber = traversalNumber;
@@ -122,16 +141,51 @@ void Skeleton::updateBoneMatrices(unsigned int traversalNumber)
 
     if (mNeedToUpdateBoneMatrices)
     {
+        bool changed = false;
         if (mRootBone.get())
         {
             for (unsigned int i=0; i<mRootBone->mChildren.size(); ++i)
-                mRootBone->mChildren[i]->update(NULL);
+                changed |= mRootBone->mChildren[i]->update(NULL);
         }
+        if (changed)
+            ++mBoneMatricesVersion;
 
         mNeedToUpdateBoneMatrices = false;
     }
 }
 
+unsigned int Skeleton::getBoneMatricesVersion() const
+{
+    return mBoneMatricesVersion;
+}
+
+void Skeleton::setUpdateThrottling(float distance, unsigned int frameInterval)
+{
+    mThrottlingDistance = distance;
+    mThrottlingInterval = std::max(1u, frameInterval);
+}
+
+bool Skeleton::isThrottled(unsigned int traversalNumber)
+{
+    if (traversalNumber == mThrottlingFrame)
+        return mThrottled;
+    mThrottlingFrame = traversalNumber;
+
+    // The cull traversal comes after the update traversal, so a visible skeleton was last culled in the previous frame
+    bool visible = mDistanceFrame + 1 >= traversalNumber;
+    bool distant = !visible || mDistanceToViewer > mThrottlingDistance;
+
+    // Alternate between even and odd frames, so that both children of a FrameSwitch get their update callbacks
+    bool due = traversalNumber - mLastUnthrottledFrame >= mThrottlingInterval
+            && (mThrottlingInterval == 1 || traversalNumber % 2 != mLastUnthrottledFrame % 2);
+
+    // Like for inactive skeletons, both children of a FrameSwitch need to be initialized before we may skip frames
+    mThrottled = mThrottlingDistance > 0.f && distant && !due && mTraversedEvenFrame && mTraversedOddFrame;
+    if (!mThrottled)
+        mLastUnthrottledFrame = traversalNumber;
+    return mThrottled;
+}
+
 void Skeleton::setActive(bool active)
 {
     mActive = active;
@@ -152,6 +206,23 @@ void Skeleton::markDirty()
 
 void Skeleton::traverse(osg::NodeVisitor& nv)
 {
+    if (nv.getVisitorType() == osg::NodeVisitor::CULL_VISITOR)
+    {
+        float distance = nv.getDistanceToViewPoint(getBound().center(), true);
+        if (nv.getTraversalNumber() != mDistanceFrame)
+        {
+            mDistanceToViewer = distance;
+            mDistanceFrame = nv.getTraversalNumber();
+        }
+        else
+            mDistanceToViewer = std::min(mDistanceToViewer, distance);
+    }
+
+    // Animation time is absolute, so controllers skipped on throttled frames catch up the next time they run.
+    // Movement is not affected either, since the animation code evaluates the accumulation root on its own.
+    if (nv.getVisitorType() == osg::NodeVisitor::UPDATE_VISITOR && isThrottled(nv.getTraversalNumber()))
+        return;
+
     if (!getActive() && nv.getVisitorType() == osg::NodeVisitor::UPDATE_VISITOR
             // need to process at least 2 frames before shutting off update, since we need to have both frame-alternating RigGeometries initialized
             // this would be more naturally handled if the double-buffering was implemented in RigGeometry itself rather than in a FrameSwitch decorator node
@@ -182,22 +253,27 @@ Bone::~Bone()
     mChildren.clear();
 }
 
-void Bone::update(const osg::Matrixf* parentMatrixInSkeletonSpace)
+bool Bone::update(const osg::Matrixf* parentMatrixInSkeletonSpace)
 {
     if (!mNode)
     {
         std::cerr << "Error: Bone without node " << std::endl;
-        return;
+        return false;
     }
+    osg::Matrixf matrixInSkeletonSpace;
     if (parentMatrixInSkeletonSpace)
-        mMatrixInSkeletonSpace = mNode->getMatrix() * (*parentMatrixInSkeletonSpace);
+        matrixInSkeletonSpace = mNode->getMatrix() * (*parentMatrixInSkeletonSpace);
     else
-        mMatrixInSkeletonSpace = mNode->getMatrix();
+        matrixInSkeletonSpace = mNode->getMatrix();
+
+    bool changed = matrixInSkeletonSpace != mMatrixInSkeletonSpace;
+    mMatrixInSkeletonSpace = matrixInSkeletonSpace;
 
     for (unsigned int i=0; i<mChildren.size(); ++i)
     {
-        mChildren[i]->update(&mMatrixInSkeletonSpace);
+        changed |= mChildren[i]->update(&mMatrixInSkeletonSpace);
     }
+    return changed;
 }
 
 }
@@ -23,7 +23,8 @@ namespace SceneUtil
         std::vector<Bone*> mChildren;
 
         /// Update the skeleton-space matrix of this bone and all its children.
-        void update(const osg::Matrixf* parentMatrixInSkeletonSpace);
+        /// @return Did the matrix of this bone or any of its children change?
+        bool update(const osg::Matrixf* parentMatrixInSkeletonSpace);
 
     private:
         Bone(const Bone&);
@@ -44,9 +45,19 @@ namespace SceneUtil
         /// Retrieve a bone by name.
         Bone* getBone(const std::string& name);
 
-        /// Request an update of bone matrices. May be a no-op if already updated in this frame.
+        /// Request an update of bone matrices. May be a no-op if already updated in this frame,
+        /// or if the update is throttled (see setUpdateThrottling).
         void updateBoneMatrices(unsigned int traversalNumber);
 
+        /// Incremented every time the bone matrices change. Rigs that have already been skinned for the current
+        /// version do not need to be skinned again.
+        unsigned int getBoneMatricesVersion() const;
+
+        /// While the skeleton is further than \a distance from the viewer or not visible at all, only run the update
+        /// traversal of its children (i.e. the animation controllers) and update its bone matrices about every
+        /// \a frameInterval frames. A distance of 0 disables throttling.
+        void setUpdateThrottling(float distance, unsigned int frameInterval);
+
         /// Set the skinning active flag. Inactive skeletons will not have their child rigs updated.
         /// You should set this flag to false if you know that bones are not currently moving.
         void setActive(bool active);
@@ -70,6 +81,20 @@ namespace SceneUtil
         bool mBoneCacheInit;
 
         bool mNeedToUpdateBoneMatrices;
+        unsigned int mBoneMatricesVersion;
+
+        float mThrottlingDistance;
+        unsigned int mThrottlingInterval;
+        unsigned int mLastUnthrottledFrame;
+        unsigned int mThrottlingFrame;
+        bool mThrottled;
+
+        /// Is the update throttled in the given frame? Decided on the first call in each frame.
+        bool isThrottled(unsigned int traversalNumber);
+
+        // Closest distance to the viewer of any cull traversal in mDistanceFrame
+        float mDistanceToViewer;
+        unsigned int mDistanceFrame;
 
         bool mActive;
 
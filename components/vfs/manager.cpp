@@ -26,6 +26,33 @@ namespace
         std::transform(path.begin(), path.end(), path.begin(), normalize_char);
     }
 
+    /// FNV-1a hash of the normalized form of the given path, computed without normalizing a copy first
+    size_t hash_path(const std::string& path, bool strict)
+    {
+        char (*normalize_char)(char) = strict ? &strict_normalize_char : &nonstrict_normalize_char;
+        size_t hash = 2166136261u;
+        for (std::string::const_iterator it = path.begin(); it != path.end(); ++it)
+        {
+            hash ^= static_cast<unsigned char>(normalize_char(*it));
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    /// Compare a path against an already normalized one, normalizing it on the fly
+    bool equal_path(const std::string& path, const std::string& normalized, bool strict)
+    {
+        if (path.size() != normalized.size())
+            return false;
+        char (*normalize_char)(char) = strict ? &strict_normalize_char : &nonstrict_normalize_char;
+        for (size_t i=0; i<path.size(); ++i)
+        {
+            if (normalize_char(path[i]) != normalized[i])
+                return false;
+        }
+        return true;
+    }
+
 }
 
 namespace VFS
@@ -55,30 +82,67 @@ namespace VFS
 
         for (std::vector<Archive*>::const_iterator it = mArchives.begin(); it != mArchives.end(); ++it)
             (*it)->listResources(mIndex, mStrict ? &strict_normalize_char : &nonstrict_normalize_char);
+
+        // keep the load factor at or below 0.5 so probe sequences stay short
+        size_t size = 16;
+        while (size < mIndex.size() * 2)
+            size *= 2;
+
+        HashEntry empty = { 0, NULL, NULL };
+        mHashIndex.assign(size, empty);
+        for (std::map<std::string, File*>::const_iterator it = mIndex.begin(); it != mIndex.end(); ++it)
+        {
+            size_t hash = hash_path(it->first, mStrict);
+            size_t slot = hash & (size-1);
+            while (mHashIndex[slot].mName)
+                slot = (slot+1) & (size-1);
+
+            HashEntry& entry = mHashIndex[slot];
+            entry.mHash = hash;
+            entry.mName = &it->first;
+            entry.mFile = it->second;
+        }
     }
 
-    Files::IStreamPtr Manager::get(const std::string &name) const
+    const Manager::HashEntry* Manager::lookup(const std::string &name) const
     {
-        std::string normalized = name;
-        normalize_path(normalized, mStrict);
+        if (mHashIndex.empty())
+            return NULL;
+
+        size_t mask = mHashIndex.size()-1;
+        size_t hash = hash_path(name, mStrict);
+        for (size_t slot = hash & mask; mHashIndex[slot].mName; slot = (slot+1) & mask)
+        {
+            const HashEntry& entry = mHashIndex[slot];
+            if (entry.mHash == hash && equal_path(name, *entry.mName, mStrict))
+                return &entry;
+        }
+        return NULL;
+    }
 
-        return getNormalized(normalized);
+    Files::IStreamPtr Manager::get(const std::string &name) const
+    {
+        const HashEntry* found = lookup(name);
+        if (!found)
+        {
+            std::string normalized = name;
+            normalize_path(normalized, mStrict);
+            throw std::runtime_error("Resource '" + normalized + "' not found");
+        }
+        return found->mFile->open();
     }
 
     Files::IStreamPtr Manager::getNormalized(const std::string &normalizedName) const
     {
-        std::map<std::string, File*>::const_iterator found = mIndex.find(normalizedName);
-        if (found == mIndex.end())
+        const HashEntry* found = lookup(normalizedName);
+        if (!found)
             throw std::runtime_error("Resource '" + normalizedName + "' not found");
-        return found->second->open();
+        return found->mFile->open();
     }
 
     bool Manager::exists(const std::string &name) const
     {
-        std::string normalized = name;
-        normalize_path(normalized, mStrict);
-
-        return mIndex.find(normalized) != mIndex.end();
+        return lookup(name) != NULL;
     }
 
     const std::map<std::string, File*>& Manager::getIndex() const
@@ -91,4 +155,15 @@ namespace VFS
         normalize_path(name, mStrict);
     }
 
+    const std::string& Manager::normalizeFilename(const std::string &name, std::string &buffer) const
+    {
+        const HashEntry* found = lookup(name);
+        if (found)
+            return *found->mName;
+
+        buffer = name;
+        normalize_path(buffer, mStrict);
+        return buffer;
+    }
+
 }
@@ -45,6 +45,11 @@ namespace VFS
         /// @note May be called from any thread once the index has been built.
         void normalizeFilename(std::string& name) const;
 
+        /// Get the normalized form of the given filename. If the file exists, returns a reference to the name stored in
+        /// the index without allocating, otherwise normalizes a copy into \a buffer and returns a reference to that.
+        /// @note May be called from any thread once the index has been built.
+        const std::string& normalizeFilename(const std::string& name, std::string& buffer) const;
+
         /// Retrieve a file by name.
         /// @note Throws an exception if the file can not be found.
         /// @note May be called from any thread once the index has been built.
@@ -56,11 +61,24 @@ namespace VFS
         Files::IStreamPtr getNormalized(const std::string& normalizedName) const;
 
     private:
+        struct HashEntry
+        {
+            size_t mHash;
+            const std::string* mName;
+            File* mFile;
+        };
+
+        /// Find the index entry for the given, not necessarily normalized, filename. Returns NULL if not found.
+        const HashEntry* lookup(const std::string& name) const;
+
         bool mStrict;
 
         std::vector<Archive*> mArchives;
 
         std::map<std::string, File*> mIndex;
+
+        /// Open addressing hash table over the names stored in mIndex, the size is always a power of two.
+        std::vector<HashEntry> mHashIndex;
     };
 
 }